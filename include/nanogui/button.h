@@ -22,6 +22,9 @@ NAMESPACE_BEGIN(nanogui)
  */
 class NANOGUI_EXPORT Button : public Widget {
 public:
+    /// Tag identifying this class (see \ref widget_cast())
+    static constexpr TypeTag StaticTypeTag = TypeButton;
+
     /// Flags to specify the button behavior (can be combined with binary OR)
     enum Flags {
         NormalButton = (1 << 0), // 1
@@ -41,25 +44,25 @@ public:
     Button(Widget *parent, const std::string &caption = "Untitled", int icon = 0);
 
     const std::string &caption() const { return mCaption; }
-    void setCaption(const std::string &caption) { mCaption = caption; }
+    void setCaption(const std::string &caption) { mCaption = caption; invalidate(); invalidatePreferredSize(); }
 
     const Color &backgroundColor() const { return mBackgroundColor; }
-    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; }
+    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; invalidate(); }
 
     const Color &textColor() const { return mTextColor; }
-    void setTextColor(const Color &textColor) { mTextColor = textColor; }
+    void setTextColor(const Color &textColor) { mTextColor = textColor; invalidate(); }
 
     int icon() const { return mIcon; }
-    void setIcon(int icon) { mIcon = icon; }
+    void setIcon(int icon) { mIcon = icon; invalidate(); invalidatePreferredSize(); }
 
     int flags() const { return mFlags; }
-    void setFlags(int buttonFlags) { mFlags = buttonFlags; }
+    void setFlags(int buttonFlags) { mFlags = buttonFlags; invalidate(); }
 
     IconPosition iconPosition() const { return mIconPosition; }
-    void setIconPosition(IconPosition iconPosition) { mIconPosition = iconPosition; }
+    void setIconPosition(IconPosition iconPosition) { mIconPosition = iconPosition; invalidate(); }
 
     bool pushed() const { return mPushed; }
-    void setPushed(bool pushed) { mPushed = pushed; }
+    void setPushed(bool pushed) { mPushed = pushed; invalidate(); }
 
     /// Set the push callback (for any type of button)
     std::function<void()> callback() const { return mCallback; }
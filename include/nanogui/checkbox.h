@@ -27,13 +27,13 @@ public:
              const std::function<void(bool)> &callback = std::function<void(bool)>());
 
     const std::string &caption() const { return mCaption; }
-    void setCaption(const std::string &caption) { mCaption = caption; }
+    void setCaption(const std::string &caption) { mCaption = caption; invalidate(); invalidatePreferredSize(); }
 
     const bool &checked() const { return mChecked; }
-    void setChecked(const bool &checked) { mChecked = checked; }
+    void setChecked(const bool &checked) { mChecked = checked; invalidate(); }
 
     const bool &pushed() const { return mPushed; }
-    void setPushed(const bool &pushed) { mPushed = pushed; }
+    void setPushed(const bool &pushed) { mPushed = pushed; invalidate(); }
 
     std::function<void(bool)> callback() const { return mCallback; }
     void setCallback(const std::function<void(bool)> &callback) { mCallback = callback; }
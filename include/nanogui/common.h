@@ -358,6 +358,10 @@ class CheckBox;
 class ColorWheel;
 class ColorPicker;
 class ComboBox;
+class EventRecorder;
+class FontMetrics;
+class FrameStats;
+class FrameStatsOverlay;
 class GLFramebuffer;
 class GLShader;
 class GridLayout;
@@ -366,10 +370,12 @@ class ImagePanel;
 class ImageView;
 class Label;
 class Layout;
+class ListView;
 class MessageDialog;
 class Object;
 class Popup;
 class PopupButton;
+class Profiler;
 class ProgressBar;
 class Screen;
 class Serializer;
@@ -377,11 +383,18 @@ class Slider;
 class StackedWidget;
 class TabHeader;
 class TabWidget;
+class TableView;
+class TaskQueue;
 class TextBox;
+struct TextLayout;
+class TextLayoutCache;
+class ThreadPool;
 class Theme;
 class ToolButton;
 class VScrollPanel;
 class Widget;
+class WidgetList;
+class WidgetPool;
 class Window;
 
 #endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -407,9 +420,12 @@ extern NANOGUI_EXPORT void shutdown();
  *
  * \param refresh
  *     NanoGUI issues a redraw call whenever an keyboard/mouse/.. event is
- *     received. In the absence of any external events, it enforces a redraw
- *     once every ``refresh`` milliseconds. To disable the refresh timer,
- *     specify a negative value here.
+ *     received. In the absence of any external events, it sleeps until the
+ *     earliest deadline registered via \ref Widget::scheduleRedraw(). Screens
+ *     that are invalidated while being drawn (e.g. by animated contents that
+ *     do not register deadlines) are redrawn again after ``refresh``
+ *     milliseconds. To disable this periodic refresh, specify a negative
+ *     value here.
  *
  * \param detach
  *     This pararameter only exists in the Python bindings. When the active
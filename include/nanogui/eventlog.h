@@ -0,0 +1,134 @@
+/*
+    nanogui/eventlog.h -- Recording and deterministic replay of the input
+    events received by a screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \struct RecordedEvent eventlog.h nanogui/eventlog.h
+ *
+ * \brief A single input event as stored in an event log.
+ */
+struct RecordedEvent {
+    enum class Type : uint8_t {
+        CursorPos = 0, MouseButton, Key, Char, Scroll, Drop, Resize
+    };
+
+    /// The kind of event (determines which of the fields below are used)
+    Type type;
+    /// Time in seconds since the start of the recording
+    double time;
+    /// Cursor position (\c CursorPos) or scroll offset (\c Scroll)
+    double x = 0, y = 0;
+    /// Integer arguments of the callback (button/action/modifiers, key/scancode/action/mods, codepoint, size)
+    int args[4] = { 0, 0, 0, 0 };
+    /// Dropped file names (\c Drop)
+    std::vector<std::string> filenames;
+};
+
+/**
+ * \class EventRecorder eventlog.h nanogui/eventlog.h
+ *
+ * \brief Writes the input events received by a \ref Screen to a compact
+ * binary log file.
+ *
+ * Attach it using \ref Screen::setEventRecorder(). Every call of one of the
+ * \c *CallbackEvent() functions of the screen is then appended to the log,
+ * along with the time elapsed since the recorder was created.
+ */
+class NANOGUI_EXPORT EventRecorder {
+public:
+    /// Create a new log file (throws \c std::runtime_error on failure)
+    EventRecorder(const std::string &filename);
+
+    /// Write any buffered events and close the log file
+    ~EventRecorder();
+
+    /// Append an event to the log (its time is filled in automatically)
+    void record(RecordedEvent event);
+
+    /// Write the buffered events to the log file
+    void flush() { mStream.flush(); }
+
+    /// Return the number of events recorded so far
+    size_t eventCount() const { return mEventCount; }
+
+protected:
+    std::ofstream mStream;
+    std::chrono::steady_clock::time_point mStart;
+    size_t mEventCount;
+};
+
+/**
+ * \class EventPlayer eventlog.h nanogui/eventlog.h
+ *
+ * \brief Replays a log written by \ref EventRecorder against a \ref Screen.
+ *
+ * The player maintains its own clock, which starts at zero and only moves
+ * when \ref advance() is called. Installing it as the clock of the screen
+ * (see \ref Screen::setClock()) makes time-dependent behavior such as
+ * tooltips and double clicks reproducible, e.g.
+ *
+ * \code
+ * EventPlayer player("session.log");
+ * screen->setClock([&player]() { return player.time(); });
+ * while (!player.finished()) {
+ *     player.advance(screen, player.time() + 1.0 / 60.0);
+ *     screen->processDeadlines(player.time());
+ *     screen->drawAll();
+ * }
+ * \endcode
+ */
+class NANOGUI_EXPORT EventPlayer {
+public:
+    /// Load a log file (throws \c std::runtime_error on failure)
+    EventPlayer(const std::string &filename);
+
+    /// Return the current time of the player's clock
+    double time() const { return mTime; }
+
+    /// Return the time of the last event in the log
+    double duration() const { return mEvents.empty() ? 0.0 : mEvents.back().time; }
+
+    /// Return whether all events have been dispatched
+    bool finished() const { return mNext == mEvents.size(); }
+
+    /// Return the loaded events
+    const std::vector<RecordedEvent> &events() const { return mEvents; }
+
+    /**
+     * \brief Move the clock forward to \c time, dispatching all events up to
+     * that point to \c screen in their original order
+     *
+     * While an event is dispatched, the clock reads that event's timestamp.
+     * Returns the number of dispatched events.
+     */
+    size_t advance(Screen *screen, double time);
+
+    /// Rewind to the beginning of the log
+    void rewind() { mNext = 0; mTime = 0; }
+
+protected:
+    std::vector<RecordedEvent> mEvents;
+    size_t mNext;
+    double mTime;
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,118 @@
+/*
+    nanogui/fontmetrics.h -- Thread-safe text measurement that does not
+    require a NanoVG context
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class FontMetrics fontmetrics.h nanogui/fontmetrics.h
+ *
+ * \brief Measures text using the TrueType data of a font, without involving
+ * NanoVG or OpenGL.
+ *
+ * The measurements follow the conventions of NanoVG (font sizes refer to the
+ * distance between ascender and descender, glyph advances and kerning are
+ * rounded to whole pixels) so that they agree with \c nvgTextBounds() and \c
+ * nvgTextBoxBounds() at a device pixel ratio of 1. This allows widgets to
+ * compute their preferred size on any thread, and before a window or NanoVG
+ * context exists.
+ *
+ * Glyph indices, advances and kerning of the printable ASCII characters are
+ * tabulated when a font is added and can be read without synchronization.
+ * Other characters are cached on first use under a per-font lock. All member
+ * functions may be called concurrently.
+ */
+class NANOGUI_EXPORT FontMetrics {
+public:
+    /**
+     * \brief Return the instance used by the built-in widgets
+     *
+     * It knows the fonts that \ref Theme registers with NanoVG, i.e. \c
+     * "sans", \c "sans-bold" and \c "icons".
+     */
+    static FontMetrics &instance();
+
+    /// Create an instance without any fonts
+    FontMetrics();
+
+    /// Release the cached metrics
+    ~FontMetrics();
+
+    /**
+     * \brief Register a TrueType font under the given name
+     *
+     * The data is not copied and must remain valid for the lifetime of this
+     * instance. Throws \c std::runtime_error if the data cannot be parsed.
+     */
+    void addFont(const std::string &name, const uint8_t *data, size_t size);
+
+    /// Return whether a font of the given name has been registered
+    bool hasFont(const std::string &name) const;
+
+    /// Return the advance width of a UTF-8 string, as computed by \c nvgTextBounds()
+    float textWidth(const std::string &font, float size, const char *string,
+                    const char *end = nullptr) const;
+
+    /// Return the advance width of a UTF-8 string, as computed by \c nvgTextBounds()
+    float textWidth(const std::string &font, float size, const std::string &string) const {
+        return textWidth(font, size, string.data(), string.data() + string.size());
+    }
+
+    /// Return the ascender, descender and line height of a font, as computed by \c nvgTextMetrics()
+    void verticalMetrics(const std::string &font, float size, float *ascender,
+                         float *descender, float *lineHeight) const;
+
+    /// Return the distance between the baselines of two lines of text
+    float lineHeight(const std::string &font, float size) const;
+
+    /**
+     * \brief Return the size of a paragraph that is wrapped at \c breakWidth
+     *
+     * The text is broken into rows at white space and explicit line breaks,
+     * and words that are wider than a row are broken between characters
+     * (like \c nvgTextBreakLines() does for Latin text). The result contains
+     * the width of the widest row and the height of all rows, which matches
+     * the vertical extent reported by \c nvgTextBoxBounds().
+     */
+    Vector2f textBoxSize(const std::string &font, float size, float breakWidth,
+                         const std::string &string) const;
+
+    /**
+     * \brief Break a paragraph into rows like \ref textBoxSize() and record
+     * the byte ranges of the rows and the positions of all glyphs
+     *
+     * A non-positive \c breakWidth puts the whole string into a single row
+     * whose width matches the advance reported by \c nvgTextBounds().
+     */
+    void layoutText(const std::string &font, float size, float breakWidth,
+                    const std::string &string, TextLayout &layout) const;
+
+protected:
+    struct Font;
+
+    /// Look up a registered font (throws \c std::runtime_error if it is unknown)
+    const Font &font(const std::string &name) const;
+
+protected:
+    std::map<std::string, std::unique_ptr<Font>> mFonts;
+    mutable std::mutex mMutex;
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,85 @@
+/*
+    nanogui/framestats.h -- Ring buffer of per-frame timing statistics
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class FrameStats framestats.h nanogui/framestats.h
+ *
+ * \brief Records how long the phases of the most recent frames took.
+ *
+ * \ref Screen records one sample per call to \ref Screen::drawAll(). Samples
+ * are kept in a fixed-size ring buffer that a single thread writes to while
+ * other threads may read it concurrently without taking a lock. Times are
+ * measured on the CPU in milliseconds; GPU work that the driver defers is
+ * typically attributed to the buffer swap.
+ */
+class NANOGUI_EXPORT FrameStats {
+public:
+    /// The phases of a frame
+    enum Phase {
+        Layout = 0, ///< \ref Screen::performLayout() calls since the previous frame
+        Contents,   ///< \ref Screen::drawContents()
+        Draw,       ///< Widget \ref Widget::draw() calls, including tooltips
+        Flush,      ///< \c nvgEndFrame(), i.e. submitting the NanoVG geometry to OpenGL
+        Swap,       ///< Presenting the frame (\c glfwSwapBuffers())
+        Total,      ///< The whole frame
+        PhaseCount
+    };
+
+    /// Timings of a single frame in milliseconds, indexed by \ref Phase
+    using Sample = std::array<float, PhaseCount>;
+
+    /// Summary statistics of one phase in milliseconds
+    struct Summary {
+        float min = 0.f, mean = 0.f, p95 = 0.f, p99 = 0.f, max = 0.f;
+    };
+
+    /// Create a ring buffer that keeps the specified number of frames
+    FrameStats(size_t capacity = 256);
+
+    /// Append a sample, overwriting the oldest one if the buffer is full
+    void record(const Sample &sample);
+
+    /// Discard all samples
+    void clear();
+
+    /// Return the number of frames that can be stored
+    size_t capacity() const { return mCapacity; }
+
+    /// Return the number of frames recorded since construction or \ref clear()
+    size_t frameCount() const { return mCount.load(std::memory_order_acquire); }
+
+    /// Return a copy of the retained samples, oldest first
+    std::vector<Sample> samples() const;
+
+    /// Compute statistics of a phase over the retained samples
+    Summary summary(Phase phase) const;
+
+    /// Return a human-readable name of a phase
+    static const char *phaseName(Phase phase);
+
+protected:
+    size_t mCapacity;
+    std::unique_ptr<std::atomic<float>[]> mData;
+    std::atomic<size_t> mCount;
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,45 @@
+/*
+    nanogui/framestatsoverlay.h -- Widget that displays the frame timings
+    of the enclosing screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class FrameStatsOverlay framestatsoverlay.h nanogui/framestatsoverlay.h
+ *
+ * \brief Displays the per-phase statistics of \ref Screen::frameStats()
+ * along with a plot of recent frame times.
+ *
+ * The overlay is typically added as a direct child of the \ref Screen and
+ * positioned by hand. To stay current, it invalidates itself whenever it is
+ * drawn, which keeps the screen redrawing continuously while it is visible.
+ */
+class NANOGUI_EXPORT FrameStatsOverlay : public Widget {
+public:
+    FrameStatsOverlay(Widget *parent);
+
+    /// Return the frame time (in milliseconds) marked in the plot
+    float targetFrameTime() const { return mTargetFrameTime; }
+    /// Set the frame time (in milliseconds) marked in the plot
+    void setTargetFrameTime(float targetFrameTime) { mTargetFrameTime = targetFrameTime; invalidate(); }
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual void draw(NVGcontext *ctx) override;
+protected:
+    float mTargetFrameTime;
+};
+
+NAMESPACE_END(nanogui)
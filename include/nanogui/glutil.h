@@ -396,8 +396,8 @@ public:
     /// Release/unbind the framebuffer object
     void release();
 
-    /// Blit the framebuffer object onto the screen
-    void blit();
+    /// Blit the framebuffer object onto the screen (optionally skipping the depth buffer)
+    void blit(bool depth = true);
 
     /// Return whether or not the framebuffer object has been initialized
     bool ready() { return mFramebuffer != 0; }
@@ -405,6 +405,9 @@ public:
     /// Return the number of MSAA samples
     int samples() const { return mSamples; }
 
+    /// Return the size of the framebuffer object
+    const Vector2i &size() const { return mSize; }
+
     /// Quick and dirty method to write a TGA (32bpp RGBA) file of the framebuffer contents for debugging
     void downloadTGA(const std::string &filename);
 protected:
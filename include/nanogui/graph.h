@@ -26,26 +26,26 @@ public:
     Graph(Widget *parent, const std::string &caption = "Untitled");
 
     const std::string &caption() const { return mCaption; }
-    void setCaption(const std::string &caption) { mCaption = caption; }
+    void setCaption(const std::string &caption) { mCaption = caption; invalidate(); }
 
     const std::string &header() const { return mHeader; }
-    void setHeader(const std::string &header) { mHeader = header; }
+    void setHeader(const std::string &header) { mHeader = header; invalidate(); }
 
     const std::string &footer() const { return mFooter; }
-    void setFooter(const std::string &footer) { mFooter = footer; }
+    void setFooter(const std::string &footer) { mFooter = footer; invalidate(); }
 
     const Color &backgroundColor() const { return mBackgroundColor; }
-    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; }
+    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; invalidate(); }
 
     const Color &foregroundColor() const { return mForegroundColor; }
-    void setForegroundColor(const Color &foregroundColor) { mForegroundColor = foregroundColor; }
+    void setForegroundColor(const Color &foregroundColor) { mForegroundColor = foregroundColor; invalidate(); }
 
     const Color &textColor() const { return mTextColor; }
-    void setTextColor(const Color &textColor) { mTextColor = textColor; }
+    void setTextColor(const Color &textColor) { mTextColor = textColor; invalidate(); }
 
     const VectorXf &values() const { return mValues; }
     VectorXf &values() { return mValues; }
-    void setValues(const VectorXf &values) { mValues = values; }
+    void setValues(const VectorXf &values) { mValues = values; invalidate(); }
 
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext *ctx) override;
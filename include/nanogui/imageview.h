@@ -43,9 +43,9 @@ public:
     Vector2f scaledImageSizeF() const { return (mScale * mImageSize.cast<float>()); }
 
     const Vector2f& offset() const { return mOffset; }
-    void setOffset(const Vector2f& offset) { mOffset = offset; }
+    void setOffset(const Vector2f& offset) { mOffset = offset; invalidate(); }
     float scale() const { return mScale; }
-    void setScale(float scale) { mScale = scale > 0.01f ? scale : 0.01f; }
+    void setScale(float scale) { mScale = scale > 0.01f ? scale : 0.01f; invalidate(); }
 
     bool fixedOffset() const { return mFixedOffset; }
     void setFixedOffset(bool fixedOffset) { mFixedOffset = fixedOffset; }
@@ -56,10 +56,10 @@ public:
     void setZoomSensitivity(float zoomSensitivity) { mZoomSensitivity = zoomSensitivity; }
 
     float gridThreshold() const { return mGridThreshold; }
-    void setGridThreshold(float gridThreshold) { mGridThreshold = gridThreshold; }
+    void setGridThreshold(float gridThreshold) { mGridThreshold = gridThreshold; invalidate(); }
 
     float pixelInfoThreshold() const { return mPixelInfoThreshold; }
-    void setPixelInfoThreshold(float pixelInfoThreshold) { mPixelInfoThreshold = pixelInfoThreshold; }
+    void setPixelInfoThreshold(float pixelInfoThreshold) { mPixelInfoThreshold = pixelInfoThreshold; invalidate(); }
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
     void setPixelInfoCallback(const std::function<std::pair<std::string, Color>(const Vector2i&)>& callback) {
@@ -70,7 +70,7 @@ public:
     }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
-    void setFontScaleFactor(float fontScaleFactor) { mFontScaleFactor = fontScaleFactor; }
+    void setFontScaleFactor(float fontScaleFactor) { mFontScaleFactor = fontScaleFactor; invalidate(); }
     float fontScaleFactor() const { return mFontScaleFactor; }
 
     // Image transformation functions.
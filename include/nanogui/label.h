@@ -26,23 +26,26 @@ NAMESPACE_BEGIN(nanogui)
  */
 class NANOGUI_EXPORT Label : public Widget {
 public:
+    /// Tag identifying this class (see \ref widget_cast())
+    static constexpr TypeTag StaticTypeTag = TypeLabel;
+
     Label(Widget *parent, const std::string &caption,
           const std::string &font = "sans", int fontSize = -1);
 
     /// Get the label's text caption
     const std::string &caption() const { return mCaption; }
     /// Set the label's text caption
-    void setCaption(const std::string &caption) { mCaption = caption; }
+    void setCaption(const std::string &caption) { mCaption = caption; invalidate(); invalidatePreferredSize(); }
 
     /// Set the currently active font (2 are available by default: 'sans' and 'sans-bold')
-    void setFont(const std::string &font) { mFont = font; }
+    void setFont(const std::string &font) { mFont = font; invalidate(); invalidatePreferredSize(); }
     /// Get the currently active font
     const std::string &font() const { return mFont; }
 
     /// Get the label color
     Color color() const { return mColor; }
     /// Set the label color
-    void setColor(const Color& color) { mColor = color; }
+    void setColor(const Color& color) { mColor = color; invalidate(); }
 
     /// Set the \ref Theme used to draw this widget
     virtual void setTheme(Theme *theme) override;
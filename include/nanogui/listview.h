@@ -0,0 +1,150 @@
+/*
+    nanogui/listview.h -- Scrollable list that only instantiates widgets
+    for the rows that are currently visible
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ListView listview.h nanogui/listview.h
+ *
+ * \brief Scrollable list whose rows are provided by a data source.
+ *
+ * In contrast to \ref VScrollPanel, the list view does not require a widget
+ * for every row. It queries the number of rows (and optionally the height of
+ * each row) using callbacks, and only creates widgets for the rows that
+ * intersect the visible area. When the list is scrolled, the widgets of rows
+ * that leave the visible area are reused for the rows that enter it, so that
+ * the number of widgets, the memory usage and the cost of a frame do not
+ * depend on the length of the list.
+ *
+ * The row widgets are created by the row factory callback (as children of
+ * the list view) and filled with the contents of a particular row by the
+ * bind callback. Call \ref reload() whenever the data source has changed.
+ */
+class NANOGUI_EXPORT ListView : public Widget {
+public:
+    ListView(Widget *parent);
+
+    /// Return the callback that reports the number of rows
+    const std::function<int()> &rowCountCallback() const { return mRowCountCallback; }
+    /// Set the callback that reports the number of rows
+    void setRowCountCallback(const std::function<int()> &callback) { mRowCountCallback = callback; reload(); }
+
+    /// Return the callback that reports the height of a row
+    const std::function<int(int)> &rowHeightCallback() const { return mRowHeightCallback; }
+    /**
+     * \brief Set the callback that reports the height of a row
+     *
+     * Variable row heights require a table with the offsets of all rows,
+     * which is rebuilt by \ref reload(). If all rows have the same height,
+     * use \ref setRowHeight() instead.
+     */
+    void setRowHeightCallback(const std::function<int(int)> &callback) { mRowHeightCallback = callback; reload(); }
+
+    /// Return the height of the rows (if no row height callback was specified)
+    int rowHeight() const { return mRowHeight; }
+    /// Set the height of the rows (if no row height callback was specified)
+    void setRowHeight(int rowHeight) { mRowHeight = rowHeight; reload(); }
+
+    /// Return the callback that creates a row widget
+    const std::function<Widget *(ListView *)> &rowFactory() const { return mRowFactory; }
+    /// Set the callback that creates a row widget, which must be a child of the given list view
+    void setRowFactory(const std::function<Widget *(ListView *)> &factory) { mRowFactory = factory; reload(); }
+
+    /// Return the callback that fills a row widget with the contents of a given row
+    const std::function<void(Widget *, int)> &bindCallback() const { return mBindCallback; }
+    /// Set the callback that fills a row widget with the contents of a given row
+    void setBindCallback(const std::function<void(Widget *, int)> &callback) { mBindCallback = callback; reload(); }
+
+    /// Return the number of rows reported by the data source during the last \ref reload()
+    int rowCount() const { return mRowCount; }
+
+    /// Query the data source again and bind all visible rows anew
+    void reload();
+
+    /// Bind the given row anew, if it is visible (e.g. after its contents have changed)
+    void reloadRow(int index);
+
+    /// Return the widget that currently displays the given row, or \c nullptr if the row is not visible
+    Widget *rowWidget(int index);
+
+    /// Return the index of the first visible row
+    int firstVisibleRow() const { return mFirstRow; }
+    /// Return the number of visible rows
+    int visibleRowCount() const { return (int) mRows.size(); }
+
+    /// Return the vertical scroll offset in pixels
+    int scrollOffset() const { return mScroll; }
+    /// Set the vertical scroll offset in pixels
+    void setScrollOffset(int offset);
+    /// Scroll so that the given row is entirely visible
+    void scrollToRow(int index);
+
+    /// Return the total height of all rows
+    int contentHeight() const;
+
+    virtual void performLayout(NVGcontext *ctx) override;
+    /**
+     * \brief Return the preferred size, which does not depend on the rows
+     *
+     * Measuring the rows would defeat the purpose of the list view, which is
+     * why it asks for room for ten rows of \ref rowHeight(). Use \ref
+     * setFixedSize() to choose other dimensions.
+     */
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// Return the vertical position of the top of the given row
+    int rowTop(int index) const;
+    /// Return the height of the given row
+    int rowHeightAt(int index) const;
+    /// Return the row at the given vertical position
+    int rowAt(int y) const;
+    /// Return the height of the scrollbar thumb
+    float scrollbarHeight() const;
+
+    /// Bind widgets to the rows that intersect the visible area and arrange them
+    void updateRows(NVGcontext *ctx);
+    /// Update the rows after a change of the scroll offset or the data source
+    void refreshRows();
+
+    /// The rows are never measured (see \ref preferredSize())
+    virtual bool childrenAffectPreferredSize() const override { return false; }
+
+protected:
+    std::function<int()> mRowCountCallback;
+    std::function<int(int)> mRowHeightCallback;
+    std::function<Widget *(ListView *)> mRowFactory;
+    std::function<void(Widget *, int)> mBindCallback;
+    int mRowHeight;
+    int mRowCount;
+    /* Offset of every row and the total height, if the row heights vary */
+    std::vector<int> mRowOffsets;
+    int mScroll;
+    /* Widgets displaying the rows mFirstRow, mFirstRow + 1, ... */
+    int mFirstRow;
+    std::vector<Widget *> mRows;
+    /* Hidden widgets that are ready to be bound to another row */
+    std::vector<Widget *> mSpareRows;
+    bool mReload;
+};
+
+NAMESPACE_END(nanogui)
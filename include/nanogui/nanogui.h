@@ -38,3 +38,12 @@
 #include <nanogui/stackedwidget.h>
 #include <nanogui/tabheader.h>
 #include <nanogui/tabwidget.h>
+#include <nanogui/framestatsoverlay.h>
+#include <nanogui/profiler.h>
+#include <nanogui/eventlog.h>
+#include <nanogui/fontmetrics.h>
+#include <nanogui/threadpool.h>
+#include <nanogui/textlayout.h>
+#include <nanogui/listview.h>
+#include <nanogui/tableview.h>
+#include <nanogui/widgetpool.h>
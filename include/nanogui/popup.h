@@ -26,17 +26,21 @@ NAMESPACE_BEGIN(nanogui)
  * and does not need to be created by hand.
  */
 class NANOGUI_EXPORT Popup : public Window {
+    friend class Window;
 public:
+    /// Tag identifying this class (see \ref widget_cast())
+    static constexpr TypeTag StaticTypeTag = TypePopup;
+
     /// Create a new popup parented to a screen (first argument) and a parent window
     Popup(Widget *parent, Window *parentWindow);
 
     /// Return the anchor position in the parent window; the placement of the popup is relative to it
-    void setAnchorPos(const Vector2i &anchorPos) { mAnchorPos = anchorPos; }
+    void setAnchorPos(const Vector2i &anchorPos) { mAnchorPos = anchorPos; invalidate(); }
     /// Set the anchor position in the parent window; the placement of the popup is relative to it
     const Vector2i &anchorPos() const { return mAnchorPos; }
 
     /// Set the anchor height; this determines the vertical shift relative to the anchor position
-    void setAnchorHeight(int anchorHeight) { mAnchorHeight = anchorHeight; }
+    void setAnchorHeight(int anchorHeight) { mAnchorHeight = anchorHeight; invalidate(); }
     /// Return the anchor height; this determines the vertical shift relative to the anchor position
     int anchorHeight() const { return mAnchorHeight; }
 
@@ -54,7 +58,10 @@ public:
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
 protected:
-    /// Internal helper function to maintain nested window position values
+    /// Detach the popup from its parent window
+    virtual ~Popup();
+
+    /// Place the popup next to its parent window, followed by its own popups
     virtual void refreshRelativePlacement() override;
 
 protected:
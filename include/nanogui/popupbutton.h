@@ -29,7 +29,7 @@ public:
                 int buttonIcon = 0,
                 int chevronIcon = ENTYPO_ICON_CHEVRON_SMALL_RIGHT);
 
-    void setChevronIcon(int icon) { mChevronIcon = icon; }
+    void setChevronIcon(int icon) { mChevronIcon = icon; invalidate(); }
     int chevronIcon() const { return mChevronIcon; }
 
     Popup *popup() { return mPopup; }
@@ -0,0 +1,96 @@
+/*
+    nanogui/profiler.h -- Opt-in profiler that records the time spent in
+    the draw and layout methods of individual widgets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+#include <chrono>
+#include <string>
+#include <typeinfo>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class Profiler profiler.h nanogui/profiler.h
+ *
+ * \brief Records the CPU time spent in \ref Widget::draw(), \ref
+ * Widget::preferredSize() and \ref Widget::performLayout() of every widget.
+ *
+ * NanoGUI routes the calls it makes on child widgets (from \ref Widget,
+ * \ref Screen, the layouts and the container widgets) through the static
+ * helpers below. While the profiler is inactive, they reduce to a plain
+ * virtual call. Once \ref start() has been called, each call is recorded
+ * along with the class name and \ref Widget::id() of the widget. Nested calls
+ * produce a hierarchical trace that can be written in the Chrome trace event
+ * format (viewable in \c chrome://tracing or Perfetto) using \ref
+ * saveTrace(). \ref Widget::cachedPreferredSize() measures through \ref
+ * preferredSize() whenever its cache is invalid, so every actual measurement
+ * is recorded, whereas sizes answered from the cache do not produce an event.
+ *
+ * The profiler is not thread-safe and should only be used from the thread
+ * that runs the user interface.
+ */
+class NANOGUI_EXPORT Profiler {
+public:
+    /// Discard previously recorded events and begin recording
+    static void start();
+
+    /// Stop recording (recorded events are kept until the next \ref start())
+    static void stop();
+
+    /// Return whether events are currently being recorded
+    static bool active() { return sActive; }
+
+    /// Return the number of recorded events
+    static size_t eventCount();
+
+    /// Write the recorded events to a Chrome trace event JSON file
+    static void saveTrace(const std::string &filename);
+
+    /// Record a call made by NanoGUI on behalf of \c widget
+    static void record(const Widget *widget, const char *category,
+                       std::chrono::steady_clock::time_point start);
+
+    /// Invoke \ref Widget::draw() and record its duration while active
+    static void draw(Widget *widget, NVGcontext *ctx) {
+        if (!sActive)
+            return widget->draw(ctx);
+        auto start = std::chrono::steady_clock::now();
+        widget->draw(ctx);
+        record(widget, "draw", start);
+    }
+
+    /// Invoke \ref Widget::preferredSize() and record its duration while active
+    static Vector2i preferredSize(const Widget *widget, NVGcontext *ctx) {
+        if (!sActive)
+            return widget->preferredSize(ctx);
+        auto start = std::chrono::steady_clock::now();
+        Vector2i result = widget->preferredSize(ctx);
+        record(widget, "preferredSize", start);
+        return result;
+    }
+
+    /// Invoke \ref Widget::performLayout() and record its duration while active
+    static void performLayout(Widget *widget, NVGcontext *ctx) {
+        if (!sActive)
+            return widget->performLayout(ctx);
+        auto start = std::chrono::steady_clock::now();
+        widget->performLayout(ctx);
+        record(widget, "performLayout", start);
+    }
+
+protected:
+    static bool sActive;
+};
+
+NAMESPACE_END(nanogui)
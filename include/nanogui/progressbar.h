@@ -26,7 +26,7 @@ public:
     ProgressBar(Widget *parent);
 
     float value() { return mValue; }
-    void setValue(float value) { mValue = value; }
+    void setValue(float value) { mValue = value; invalidate(); }
 
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext* ctx) override;
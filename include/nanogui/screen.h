@@ -15,6 +15,11 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <nanogui/glutil.h>
+#include <nanogui/framestats.h>
+#include <nanogui/taskqueue.h>
+#include <map>
+#include <unordered_map>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -28,6 +33,9 @@ class NANOGUI_EXPORT Screen : public Widget {
     friend class Widget;
     friend class Window;
 public:
+    /// Tag identifying this class (see \ref widget_cast())
+    static constexpr TypeTag StaticTypeTag = TypeScreen;
+
     /**
      * Create a new Screen instance
      *
@@ -76,12 +84,21 @@ public:
      *     for a forward compatible core OpenGL 4.1 profile.  Requesting an
      *     invalid profile will result in no context (and therefore no GUI)
      *     being created.
+     *
+     * \param headless
+     *     Render into an offscreen buffer instead of a window. The GLFW window
+     *     backing the OpenGL context is never shown, frames are produced by
+     *     calling \ref drawAll() by hand, and user input can be simulated by
+     *     invoking the \c *CallbackEvent() handlers. The rendered frame is
+     *     available through \ref readPixels(). To run on machines without a
+     *     display server, build NanoGUI with \c NANOGUI_USE_OSMESA.
      */
     Screen(const Vector2i &size, const std::string &caption,
            bool resizable = true, bool fullscreen = false, int colorBits = 8,
            int alphaBits = 8, int depthBits = 24, int stencilBits = 8,
            int nSamples = 0,
-           unsigned int glMajor = 3, unsigned int glMinor = 3);
+           unsigned int glMajor = 3, unsigned int glMinor = 3,
+           bool headless = false);
 
     /// Release all resources
     virtual ~Screen();
@@ -96,7 +113,7 @@ public:
     const Color &background() const { return mBackground; }
 
     /// Set the screen's background color
-    void setBackground(const Color &background) { mBackground = background; }
+    void setBackground(const Color &background) { mBackground = background; invalidate(); }
 
     /// Set the top-level window visibility (no effect on full-screen windows)
     void setVisible(bool visible);
@@ -107,12 +124,138 @@ public:
     /// Draw the Screen contents
     virtual void drawAll();
 
-    /// Draw the window contents --- put your OpenGL draw calls here
+    /// Draw the top-level windows, skipping those outside of the repainted region
+    virtual void draw(NVGcontext *ctx) override;
+
+    /**
+     * \brief Draw the window contents --- put your OpenGL draw calls here
+     *
+     * The main loop only redraws screens that have been invalidated (see \ref
+     * needsRedraw()). Animated contents should therefore call \ref
+     * invalidate() from here to request the next frame.
+     */
     virtual void drawContents() { /* To be overridden */ }
 
+    /**
+     * \brief Return whether the screen contents have changed since the last
+     * call to \ref drawAll()
+     *
+     * This flag is raised by \ref Widget::invalidate(), which is triggered by
+     * widget setters and incoming events. \ref mainloop() skips screens for
+     * which this function returns \c false.
+     */
+    bool needsRedraw() const { return mRedraw; }
+
+    /**
+     * \brief Mark a rectangle (in screen coordinates) as needing a redraw
+     *
+     * Damaged rectangles are accumulated until the next call to \ref
+     * drawAll(). This is normally invoked via \ref Widget::invalidate().
+     */
+    void invalidateRect(const Vector2i &pos, const Vector2i &size);
+
+    /**
+     * \brief Return the current time in seconds
+     *
+     * This is the time base of tooltips, redraw deadlines and double click
+     * detection. It is given by \c glfwGetTime() unless a different clock
+     * has been installed using \ref setClock().
+     */
+    double time() const;
+
+    /// Replace the clock of the screen (e.g. by the one of an \ref EventPlayer); pass an empty function to restore \c glfwGetTime()
+    void setClock(const std::function<double()> &clock) { mClock = clock; }
+
+    /// Return the recorder receiving the input events of this screen, if any
+    EventRecorder *eventRecorder() { return mEventRecorder; }
+
+    /// Record the input events of this screen (the recorder is not owned by the screen; pass \c nullptr to stop)
+    void setEventRecorder(EventRecorder *eventRecorder) { mEventRecorder = eventRecorder; }
+
+    /**
+     * \brief Invalidate \c widget once the given time (see \ref time()) has
+     * been reached
+     *
+     * Each widget has at most one pending deadline: scheduling another one
+     * replaces it. Passing the screen itself invalidates the entire screen.
+     * Normally invoked via \ref Widget::scheduleRedraw().
+     */
+    void scheduleRedraw(Widget *widget, double time);
+
+    /// Return the time of the earliest pending redraw deadline (infinity if there is none)
+    double nextDeadline() const;
+
+    /**
+     * \brief Invalidate the widgets whose redraw deadlines have expired
+     *
+     * \ref mainloop() calls this before drawing each screen. Applications
+     * with their own event loop should do the same, and may use \ref
+     * nextDeadline() to determine how long to wait for events.
+     */
+    void processDeadlines(double now);
+
+    /**
+     * \brief Run a function on the thread executing the main loop
+     *
+     * This is the only safe way for other threads to modify widgets. The
+     * function may be called from any thread; it enqueues the task without
+     * blocking and wakes up \ref mainloop(), which executes pending tasks
+     * (see \ref processTasks()) before drawing the next frame.
+     */
+    void postToUI(std::function<void()> task);
+
+    /**
+     * \brief Execute tasks submitted via \ref postToUI()
+     *
+     * Stops once the time budget (see \ref setTaskBudget()) is exhausted so
+     * that a flood of updates cannot stall input handling and drawing; the
+     * remaining tasks are executed in the following iterations of the main
+     * loop. Applications with their own event loop must call this
+     * periodically. Returns the number of executed tasks.
+     */
+    size_t processTasks();
+
+    /// Return whether tasks submitted via \ref postToUI() are waiting to be executed
+    bool hasPendingTasks() const { return !mTasks.empty(); }
+
+    /// Return the time (in seconds) that \ref processTasks() may spend per call
+    double taskBudget() const { return mTaskBudget; }
+
+    /// Set the time (in seconds) that \ref processTasks() may spend per call
+    void setTaskBudget(double taskBudget) { mTaskBudget = taskBudget; }
+
+    /// Return whether only the damaged region is repainted (see \ref setPartialRedraw())
+    bool partialRedraw() const { return mPartialRedraw; }
+
+    /**
+     * \brief Only repaint the damaged region of the screen
+     *
+     * When enabled, the screen is rendered into a persistent offscreen buffer
+     * that is copied to the window after every frame. Only the region damaged
+     * since the previous frame is cleared and redrawn, and top-level windows
+     * outside of it are skipped altogether. Note that \ref drawContents() is
+     * clipped to the same region, so an application drawing changing OpenGL
+     * content there must invalidate the screen (or the affected area) itself.
+     */
+    void setPartialRedraw(bool partialRedraw);
+
     /// Return the ratio between pixel and device coordinates (e.g. >= 2 on Mac Retina displays)
     float pixelRatio() const { return mPixelRatio; }
 
+    /// Return the size of the framebuffer in pixels
+    const Vector2i &framebufferSize() const { return mFBSize; }
+
+    /// Return whether the screen renders offscreen without a visible window
+    bool headless() const { return mHeadless; }
+
+    /**
+     * \brief Read back the most recently drawn frame
+     *
+     * Returns tightly packed 8 bit RGBA pixels of size \ref framebufferSize(),
+     * starting with the top row.
+     */
+    std::vector<uint8_t> readPixels();
+
     /// Handle a file drop event
     virtual bool dropEvent(const std::vector<std::string> & /* filenames */) { return false; /* To be overridden */ }
 
@@ -128,6 +271,25 @@ public:
     /// Return the last observed mouse position value
     Vector2i mousePos() const { return mMousePos; }
 
+    /// Return whether cursor motion is coalesced (see \ref setCoalesceMotion())
+    bool coalesceMotion() const { return mCoalesceMotion; }
+
+    /**
+     * \brief Dispatch at most one cursor motion event per frame
+     *
+     * When enabled, \ref cursorPosCallbackEvent() only records the cursor
+     * position. The motion (or drag) event is dispatched with the summed
+     * relative motion by \ref flushMotionEvents(), which runs at the start
+     * of \ref drawAll() and before any other input event so that events are
+     * still observed in order. Pending motion does not damage the screen by
+     * itself, hence applications with their own main loop must also call
+     * \ref flushMotionEvents() before checking \ref needsRedraw().
+     */
+    void setCoalesceMotion(bool coalesceMotion);
+
+    /// Dispatch a pending coalesced cursor motion event, if any
+    bool flushMotionEvents();
+
     /// Return a pointer to the underlying GLFW window data structure
     GLFWwindow *glfwWindow() { return mGLFWWindow; }
 
@@ -139,11 +301,79 @@ public:
 
     using Widget::performLayout;
 
-    /// Compute the layout of all widgets
-    void performLayout() {
-        Widget::performLayout(mNVGContext);
+    /// Compute the layout of all widgets (timed as part of \ref frameStats())
+    void performLayout();
+
+    /// Return the number of threads that measure widgets in \ref performLayout()
+    int layoutThreads() const;
+
+    /**
+     * \brief Measure independent parts of the user interface concurrently
+     * in \ref performLayout()
+     *
+     * With more than one thread, \ref performLayout() first computes the
+     * preferred sizes of all windows, and of large subtrees within them, on a
+     * work-stealing thread pool (the calling thread takes part). The layout is
+     * then applied on the calling thread, where all measurements are found in
+     * the cache (see \ref Widget::cachedPreferredSize()).
+     *
+     * Worker threads call \ref Widget::preferredSize() with a \c nullptr
+     * context. Implementations must then not touch state outside of the
+     * widget, and must throw if they cannot measure without a NanoVG context;
+     * such widgets (and their ancestors) are measured on the calling thread.
+     * The built-in widgets satisfy these requirements. Measurements are not
+     * parallelized while the \ref Profiler is active.
+     */
+    void setLayoutThreads(int threads);
+
+    using Widget::updateLayout;
+
+    /// Lay out the widgets that changed since the last layout (timed as part of \ref frameStats())
+    void updateLayout();
+
+    /// Return whether \ref drawAll() lays out changed widgets (see \ref setAutoLayout())
+    bool autoLayout() const { return mAutoLayout; }
+
+    /**
+     * \brief Call \ref updateLayout() at the start of every \ref drawAll()
+     *
+     * This removes the need to invoke \ref performLayout() after modifying
+     * the user interface. Only the smallest subtrees affected by a change are
+     * laid out again. Note that windows are resized to their preferred size
+     * (unless they have a fixed size) when their contents change size, just
+     * as if \ref performLayout() had been called.
+     */
+    void setAutoLayout(bool autoLayout) { mAutoLayout = autoLayout; }
+
+    /// Return the timings of the most recently drawn frames
+    const FrameStats &frameStats() const { return mFrameStats; }
+
+    /// Return the timings of the most recently drawn frames
+    FrameStats &frameStats() { return mFrameStats; }
+
+    /**
+     * \brief Return the widget with the given ID (see \ref Widget::setId()),
+     * or \c nullptr if there is none
+     *
+     * The screen maintains an index of the IDs of all widgets attached to it,
+     * so the lookup takes constant time. If several widgets share an ID, one
+     * of them is returned.
+     */
+    Widget *findById(const std::string &id) const;
+
+    /// Return the widget with the given ID if it is of type \c T, and \c nullptr otherwise
+    template <typename T> T *find(const std::string &id) const {
+        return dynamic_cast<T *>(findById(id));
     }
 
+    /**
+     * \brief Return a counter that is incremented whenever the ID index changes
+     *
+     * Widgets found via \ref findById() may be cached by the application and
+     * remain valid as long as this counter does not change.
+     */
+    size_t idVersion() const { return mIdVersion; }
+
 public:
     /********* API for applications which manage GLFW themselves *********/
 
@@ -174,6 +404,9 @@ public:
     bool resizeCallbackEvent(int width, int height);
 
     /* Internal helper functions */
+    bool dispatchCursorPos(double x, double y);
+    void invalidateTooltip();
+    void invalidateTooltip(const Widget *widget);
     void updateFocus(Widget *widget);
     void disposeWindow(Window *window);
     void centerWindow(Window *window);
@@ -181,6 +414,15 @@ public:
     void drawWidgets();
 
 protected:
+    /// Add the given widget to the ID index
+    void registerId(Widget *widget);
+    /// Remove the given widget from the ID index
+    void unregisterId(Widget *widget);
+    /// Add the given widget and its descendants to the ID index
+    void registerIds(Widget *widget);
+    /// Remove the given widget and its descendants from the ID index
+    void unregisterIds(Widget *widget);
+
     GLFWwindow *mGLFWWindow;
     NVGcontext *mNVGContext;
     GLFWcursor *mCursors[(int) Cursor::CursorCount];
@@ -198,6 +440,27 @@ protected:
     std::string mCaption;
     bool mShutdownGLFWOnDestruct;
     bool mFullscreen;
+    bool mHeadless;
+    bool mRedraw;
+    bool mPartialRedraw;
+    Vector2i mDamageMin, mDamageMax;
+    Vector2i mRepaintMin, mRepaintMax;
+    GLFramebuffer mBackBuffer;
+    FrameStats mFrameStats;
+    double mLayoutTime, mDrawTime, mFlushTime;
+    bool mCoalesceMotion, mMotionPending;
+    bool mAutoLayout;
+    std::unique_ptr<ThreadPool> mLayoutPool;
+    std::multimap<double, ref<Widget>> mDeadlines;
+    std::unordered_map<const Widget *, std::multimap<double, ref<Widget>>::iterator> mDeadlineIndex;
+    double mTooltipDeadline;
+    TaskQueue mTasks;
+    double mTaskBudget;
+    std::function<double()> mClock;
+    EventRecorder *mEventRecorder = nullptr;
+    double mPendingMotionX, mPendingMotionY;
+    std::unordered_multimap<std::string, Widget *> mIdIndex;
+    size_t mIdVersion = 0;
 };
 
 NAMESPACE_END(nanogui)
@@ -32,7 +32,7 @@ class NANOGUI_EXPORT TabHeader : public Widget {
 public:
     TabHeader(Widget *parent, const std::string &font = "sans-bold");
 
-    void setFont(const std::string& font) { mFont = font; }
+    void setFont(const std::string& font) { mFont = font; invalidate(); invalidatePreferredSize(); }
     const std::string& font() const { return mFont; }
     bool overflowing() const { return mOverflowing; }
 
@@ -111,7 +111,7 @@ private:
 
         TabButton(TabHeader& header, const std::string& label);
 
-        void setLabel(const std::string& label) { mLabel = label; }
+        void setLabel(const std::string& label) { mLabel = label; mHeader->invalidatePreferredSize(); }
         const std::string& label() const { return mLabel; }
         void setSize(const Vector2i& size) { mSize = size; }
         const Vector2i& size() const { return mSize; }
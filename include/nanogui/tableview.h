@@ -0,0 +1,269 @@
+/*
+    nanogui/tableview.h -- Scrollable table that draws the visible cells
+    of a column-oriented data source
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TableColumn tableview.h nanogui/tableview.h
+ *
+ * \brief A column of the data shown by a \ref TableView.
+ *
+ * Cells are only queried for the rows that are visible, and when the table
+ * is sorted. Sorting and filtering run on a background thread, which is why
+ * the functions of this class must be safe to call concurrently with those
+ * called from the user interface thread. The underlying data must not be
+ * modified while the table is displaying it; call \ref TableView::reload()
+ * after a change.
+ */
+class NANOGUI_EXPORT TableColumn {
+public:
+    virtual ~TableColumn() = default;
+
+    /// Return the number of rows
+    virtual size_t size() const = 0;
+
+    /// Return the text of the cell in the given row
+    virtual std::string text(size_t row) const = 0;
+
+    /// Return whether the cell in row \c a sorts before the cell in row \c b
+    virtual bool less(size_t a, size_t b) const = 0;
+
+    /// Return whether the column holds numbers (which are right-aligned)
+    virtual bool numeric() const { return false; }
+};
+
+NAMESPACE_BEGIN(detail)
+
+template <typename T> std::string formatCell(const T &value) {
+    std::ostringstream os;
+    os << value;
+    return os.str();
+}
+
+inline std::string formatCell(const std::string &value) { return value; }
+
+NAMESPACE_END(detail)
+
+/**
+ * \class TableColumnSpan tableview.h nanogui/tableview.h
+ *
+ * \brief A \ref TableColumn that refers to a contiguous array of values
+ * owned by the application.
+ *
+ * Values are converted to text using \c operator<<, unless a custom format
+ * function is specified, and sorted using \c operator<.
+ */
+template <typename T> class TableColumnSpan : public TableColumn {
+public:
+    using FormatFunction = std::function<std::string(const T &)>;
+
+    TableColumnSpan(const T *data, size_t size, const FormatFunction &format = FormatFunction())
+        : mData(data), mSize(size), mFormat(format) { }
+
+    /// Return the values of the column
+    const T *data() const { return mData; }
+
+    virtual size_t size() const override { return mSize; }
+
+    virtual std::string text(size_t row) const override {
+        return mFormat ? mFormat(mData[row]) : detail::formatCell(mData[row]);
+    }
+
+    virtual bool less(size_t a, size_t b) const override { return mData[a] < mData[b]; }
+
+    virtual bool numeric() const override { return std::is_arithmetic<T>::value; }
+
+protected:
+    const T *mData;
+    size_t mSize;
+    FormatFunction mFormat;
+};
+
+/**
+ * \class TableView tableview.h nanogui/tableview.h
+ *
+ * \brief Scrollable table for very large column-oriented data sets.
+ *
+ * The table draws the cells of the visible rows and columns directly
+ * instead of creating widgets for them, so its cost per frame does not
+ * depend on the number of rows. The header row stays in place while the
+ * table is scrolled. Columns can be resized by dragging the separators
+ * between their headers, and clicking on a header sorts the table by that
+ * column (clicking again reverses the order).
+ *
+ * Sorting and filtering (see \ref setSortColumn() and \ref setFilter())
+ * take place on a background thread, which produces a permutation of the
+ * row indices. The table keeps displaying the previous order until the new
+ * one is ready and then swaps it in atomically. A newer request cancels an
+ * older one that is still being processed.
+ */
+class NANOGUI_EXPORT TableView : public Widget {
+public:
+    /// Predicate that decides whether a row (given by its index in the data source) is shown
+    using Filter = std::function<bool(size_t)>;
+
+    TableView(Widget *parent);
+
+    /// Append a column with the given title and width
+    void addColumn(const std::string &title, std::shared_ptr<TableColumn> column, int width = 100);
+
+    /// Remove all columns
+    void clearColumns();
+
+    /// Return the number of columns
+    int columnCount() const { return (int) mColumns.size(); }
+    /// Return the given column
+    const std::shared_ptr<TableColumn> &column(int index) const { return mColumns.at(index).data; }
+    /// Return the title of the given column
+    const std::string &columnTitle(int index) const { return mColumns.at(index).title; }
+    /// Return the width of the given column
+    int columnWidth(int index) const { return mColumns.at(index).width; }
+    /// Set the width of the given column
+    void setColumnWidth(int index, int width);
+
+    /// Return the height of the rows and of the header
+    int rowHeight() const { return mRowHeight; }
+    /// Set the height of the rows and of the header
+    void setRowHeight(int rowHeight) { mRowHeight = rowHeight; invalidatePreferredSize(); invalidate(); }
+
+    /// Return the column by which the rows are sorted, or -1 if they appear in their original order
+    int sortColumn() const { return mSortColumn; }
+    /// Return whether the rows are sorted in ascending order
+    bool sortAscending() const { return mSortAscending; }
+    /// Sort the rows by the given column (-1 restores the original order)
+    void setSortColumn(int column, bool ascending = true);
+
+    /// Return the filter predicate
+    const Filter &filter() const { return mFilter; }
+    /// Only show the rows for which the given predicate (which must be thread-safe) returns \c true
+    void setFilter(const Filter &filter);
+
+    /// Notify the table that the data source has changed, which sorts and filters the rows again
+    void reload();
+
+    /// Return the number of rows of the data source (the smallest size of all columns)
+    size_t rowCount() const;
+
+    /// Return the number of rows that are currently shown
+    size_t visibleRowCount() const;
+
+    /// Return the index in the data source of the given shown row
+    size_t dataRow(size_t row) const;
+
+    /// Return whether a sort or filter operation is being processed in the background
+    bool busy() const { return mBusy; }
+
+    /// Return the vertical scroll offset in pixels
+    int scrollOffset() const { return mScroll.y(); }
+    /// Set the vertical scroll offset in pixels
+    void setScrollOffset(int offset);
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseMotionEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// Stop the background thread
+    virtual ~TableView();
+
+    struct Column {
+        std::string title;
+        std::shared_ptr<TableColumn> data;
+        int width;
+    };
+
+    /// Permutation of the row indices produced by the background thread
+    struct Permutation {
+        std::vector<uint32_t> rows;
+        uint64_t generation;
+        bool failed;
+    };
+
+    /// Parameters of a sort or filter operation
+    struct Query {
+        std::vector<std::shared_ptr<TableColumn>> columns;
+        size_t rowCount;
+        int sortColumn;
+        bool sortAscending;
+        Filter filter;
+        uint64_t generation;
+        /// Screen that is woken up once the result is available
+        Screen *screen;
+    };
+
+    /// Hand the current sort order and filter to the background thread
+    void submitQuery();
+
+    /// Adopt the result of the background thread if it is ready (posted to the UI thread by \ref runQuery())
+    void collectQuery();
+
+    /// Main loop of the background thread
+    void worker();
+
+    /// Compute the permutation requested by the given query
+    void runQuery(const Query &query);
+
+    /// Return the column whose right header edge is close to the given horizontal position, or -1
+    int columnEdgeAt(int x) const;
+    /// Return the column at the given horizontal position, or -1
+    int columnAt(int x) const;
+    /// Return the total width of all columns
+    int contentWidth() const;
+    /// Return the size of the area below the header, excluding the scrollbar
+    Vector2i viewSize() const;
+    /// Keep the scroll offsets within the valid range
+    void clampScroll();
+
+protected:
+    std::vector<Column> mColumns;
+    int mRowHeight;
+    int mSortColumn;
+    bool mSortAscending;
+    Filter mFilter;
+    /* Order of the shown rows, or nullptr if all rows are shown in their original order */
+    std::shared_ptr<const Permutation> mPermutation;
+    Vector2i mScroll;
+    int mResizeColumn;
+
+    /* State shared with the background thread */
+    std::thread mWorker;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    Query mQuery;
+    bool mQueryValid;
+    bool mShutdown;
+    std::atomic<uint64_t> mGeneration;
+    std::shared_ptr<const Permutation> mResult;
+    bool mBusy;
+    /* Cleared by the destructor, so that tasks posted by the background
+       thread notice that the table is gone */
+    std::shared_ptr<TableView *> mSelf;
+};
+
+NAMESPACE_END(nanogui)
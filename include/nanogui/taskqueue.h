@@ -0,0 +1,69 @@
+/*
+    nanogui/taskqueue.h -- Lock-free queue of tasks that other threads
+    submit for execution on the user interface thread
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <atomic>
+#include <functional>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TaskQueue taskqueue.h nanogui/taskqueue.h
+ *
+ * \brief Multiple-producer, single-consumer queue of tasks.
+ *
+ * Any thread may \ref push() tasks without taking a lock, while a single
+ * thread (the one running the user interface) executes them using \ref
+ * run(). Tasks are executed in the order in which they were pushed.
+ */
+class NANOGUI_EXPORT TaskQueue {
+public:
+    TaskQueue();
+
+    /// Release all tasks that were not executed
+    ~TaskQueue();
+
+    /**
+     * \brief Append a task to the queue (thread-safe)
+     *
+     * Returns \c true if the consumer should be woken up, i.e. if this is the
+     * first task since the consumer last started executing tasks.
+     */
+    bool push(std::function<void()> task);
+
+    /**
+     * \brief Execute queued tasks until the queue is empty or \c budget
+     * seconds have elapsed (consumer thread only)
+     *
+     * At least one task is executed if the queue is not empty. Returns the
+     * number of executed tasks.
+     */
+    size_t run(double budget);
+
+    /// Return whether the queue is empty (consumer thread only)
+    bool empty() const;
+
+protected:
+    struct Node {
+        std::function<void()> task;
+        std::atomic<Node *> next;
+    };
+
+    std::atomic<Node *> mHead;
+    Node *mTail;
+    std::atomic<bool> mWakeRequested;
+};
+
+NAMESPACE_END(nanogui)
@@ -41,22 +41,22 @@ public:
     void setEditable(bool editable);
 
     bool spinnable() const { return mSpinnable; }
-    void setSpinnable(bool spinnable) { mSpinnable = spinnable; }
+    void setSpinnable(bool spinnable) { mSpinnable = spinnable; invalidate(); invalidatePreferredSize(); }
 
     const std::string &value() const { return mValue; }
-    void setValue(const std::string &value) { mValue = value; }
+    void setValue(const std::string &value) { mValue = value; invalidate(); invalidatePreferredSize(); }
 
     const std::string &defaultValue() const { return mDefaultValue; }
     void setDefaultValue(const std::string &defaultValue) { mDefaultValue = defaultValue; }
 
     Alignment alignment() const { return mAlignment; }
-    void setAlignment(Alignment align) { mAlignment = align; }
+    void setAlignment(Alignment align) { mAlignment = align; invalidate(); }
 
     const std::string &units() const { return mUnits; }
-    void setUnits(const std::string &units) { mUnits = units; }
+    void setUnits(const std::string &units) { mUnits = units; invalidate(); invalidatePreferredSize(); }
 
     int unitsImage() const { return mUnitsImage; }
-    void setUnitsImage(int image) { mUnitsImage = image; }
+    void setUnitsImage(int image) { mUnitsImage = image; invalidate(); invalidatePreferredSize(); }
 
     /// Return the underlying regular expression specifying valid formats
     const std::string &format() const { return mFormat; }
@@ -0,0 +1,164 @@
+/*
+    nanogui/textlayout.h -- Line breaks and glyph positions of a string,
+    and a shared cache of them
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \struct TextLayout textlayout.h nanogui/textlayout.h
+ *
+ * \brief A string broken into rows, along with the positions of its glyphs
+ * (see \ref FontMetrics::layoutText()).
+ */
+struct NANOGUI_EXPORT TextLayout {
+    /// A code point of the string
+    struct Glyph {
+        /// Byte offset of the code point within \ref text
+        uint32_t offset;
+        /// Horizontal extent of the glyph, relative to the start of its row
+        float x, nextX;
+    };
+
+    /// A row of text (without leading and trailing white space)
+    struct Row {
+        /// Byte range of the row within \ref text
+        uint32_t begin, end;
+        /// Range of the glyphs of the row within \ref glyphs
+        uint32_t glyphBegin, glyphEnd;
+        /// Advance width of the row
+        float width;
+    };
+
+    /// The string that was laid out
+    std::string text;
+    /// The rows of text from top to bottom
+    std::vector<Row> rows;
+    /// All code points of the string (white space between rows belongs to no row)
+    std::vector<Glyph> glyphs;
+    /// Width of the widest row and height of all rows
+    Vector2f size = Vector2f::Zero();
+    /// Distance between the tops of two consecutive rows
+    float lineHeight = 0.f;
+
+    /**
+     * \brief Draw the rows with \c nvgText(), starting at the given position
+     *
+     * The font face, size and text alignment of \c ctx must have been set up
+     * by the caller. Consecutive rows are <tt>lineHeight * lineSpacing</tt>
+     * apart; pass the value given to \c nvgTextLineHeight() if any.
+     */
+    void draw(NVGcontext *ctx, float x, float y, float lineSpacing = 1.f) const;
+};
+
+/**
+ * \class TextLayoutCache textlayout.h nanogui/textlayout.h
+ *
+ * \brief Least recently used cache of text layouts keyed by string, font,
+ * font size and wrap width.
+ *
+ * The built-in widgets and the tooltips of \ref Screen obtain the layout of
+ * their text from \ref instance(), so that static text is neither measured
+ * nor broken into rows again whenever it is measured. The cache may be used
+ * from multiple threads. Lookups do not allocate memory, and every layout is
+ * computed once outside of the lock; concurrent lookups of the same text
+ * wait for it.
+ */
+class NANOGUI_EXPORT TextLayoutCache {
+public:
+    /// Return the cache used by the built-in widgets, which is backed by \ref FontMetrics::instance()
+    static TextLayoutCache &instance();
+
+    /// Create a cache that holds up to \c capacity layouts computed using \c metrics
+    TextLayoutCache(const FontMetrics &metrics, size_t capacity = 1024);
+
+    /**
+     * \brief Return the layout of \c text, computing it if necessary
+     *
+     * A non-positive \c breakWidth puts the whole string into a single row,
+     * like \c nvgText(). Throws \c std::runtime_error if the font is unknown.
+     */
+    std::shared_ptr<const TextLayout> layout(const std::string &font, float size,
+                                             const std::string &text,
+                                             float breakWidth = 0.f);
+
+    /// Return the maximum number of layouts held by the cache
+    size_t capacity() const;
+    /// Set the maximum number of layouts held by the cache, evicting the least recently used ones
+    void setCapacity(size_t capacity);
+
+    /// Return the number of layouts held by the cache
+    size_t size() const;
+    /// Discard all layouts
+    void clear();
+
+    /// Return the number of lookups that found a cached layout
+    size_t hits() const { return mHits; }
+    /// Return the number of lookups that had to compute a layout
+    size_t misses() const { return mMisses; }
+    /// Reset the hit and miss counters
+    void resetStatistics() { mHits = 0; mMisses = 0; }
+
+protected:
+    using Future = std::shared_future<std::shared_ptr<const TextLayout>>;
+
+    struct Entry {
+        std::string text, font;
+        float size, breakWidth;
+        size_t hash;
+        /* Becomes ready once the thread that missed has computed the layout */
+        Future layout;
+
+        bool matches(const std::string &font, float size, const std::string &text,
+                     float breakWidth) const {
+            return this->size == size && this->breakWidth == breakWidth &&
+                   this->text == text && this->font == font;
+        }
+    };
+
+    /// Hash the arguments of \ref layout() without copying them
+    static size_t hash(const std::string &font, float size, const std::string &text,
+                       float breakWidth);
+
+    /// Return the entry with the given key, or \c mEntries.end() (lock held)
+    std::list<Entry>::iterator find(size_t hash, const std::string &font, float size,
+                                    const std::string &text, float breakWidth);
+
+    /// Remove an entry from the index and the list of entries (lock held)
+    void erase(std::list<Entry>::iterator entry);
+
+    /// Evict least recently used entries until the capacity is respected (lock held)
+    void shrink();
+
+protected:
+    const FontMetrics &mMetrics;
+    size_t mCapacity;
+    /* Most recently used entries first */
+    std::list<Entry> mEntries;
+    /* Entries by hash, which is looked up without constructing a key */
+    std::unordered_multimap<size_t, std::list<Entry>::iterator> mIndex;
+    mutable std::mutex mMutex;
+    std::atomic<size_t> mHits, mMisses;
+};
+
+NAMESPACE_END(nanogui)
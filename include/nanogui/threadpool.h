@@ -0,0 +1,92 @@
+/*
+    nanogui/threadpool.h -- Work-stealing thread pool for fork-join
+    parallelism
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ThreadPool threadpool.h nanogui/threadpool.h
+ *
+ * \brief Thread pool that executes nested fork-join workloads.
+ *
+ * Every worker owns a double-ended queue of tasks. Workers push and pop
+ * tasks at the back of their own queue and steal from the front of the
+ * queues of other workers when they run out of work, so that subtasks of a
+ * recursive computation tend to stay on the thread that created them.
+ *
+ * A thread that waits in \ref parallelFor() executes pending tasks in the
+ * meantime. Calls may therefore be nested, and the calling thread (e.g. the
+ * user interface thread) contributes to the computation.
+ */
+class NANOGUI_EXPORT ThreadPool {
+public:
+    /// Start the given number of worker threads
+    ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+
+    /// Wait for the workers to finish their current task and join them
+    ~ThreadPool();
+
+    /// Return the number of worker threads
+    size_t threadCount() const { return mThreads.size(); }
+
+    /**
+     * \brief Invoke <tt>func(i)</tt> for every \c i in <tt>[0, count)</tt>
+     * and wait until all invocations have returned
+     *
+     * If invocations throw, the first exception is rethrown once all of them
+     * have finished.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)> &func);
+
+protected:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /// Enqueue a task on the queue of the calling worker (or the shared queue)
+    void push(Task task);
+
+    /// Execute one pending task, if any; returns whether a task was found
+    bool runOne(size_t self);
+
+    /// Main loop of worker \c index
+    void worker(size_t index);
+
+    /// Return the queue index of the calling thread within this pool
+    size_t queueIndex() const;
+
+protected:
+    /* One queue per worker, followed by a queue for threads outside of the pool */
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::vector<std::thread> mThreads;
+    std::atomic<size_t> mPending;
+    std::atomic<bool> mShutdown;
+    std::mutex mSleepMutex;
+    std::condition_variable mSleepCondition;
+};
+
+NAMESPACE_END(nanogui)
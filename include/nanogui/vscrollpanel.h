@@ -15,6 +15,8 @@
 
 #include <nanogui/widget.h>
 
+struct NVGLUframebuffer;
+
 NAMESPACE_BEGIN(nanogui)
 
 /**
@@ -22,11 +24,33 @@ NAMESPACE_BEGIN(nanogui)
  *
  * \brief Adds a vertical scrollbar around a widget that is too big to fit into
  *        a certain area.
+ *
+ * Scrolling only moves the child; it is neither measured nor laid out again.
  */
 class NANOGUI_EXPORT VScrollPanel : public Widget {
 public:
     VScrollPanel(Widget *parent);
 
+    /// Return the scroll position between 0 (top) and 1 (bottom)
+    float scroll() const { return mScroll; }
+    /// Set the scroll position between 0 (top) and 1 (bottom)
+    void setScroll(float scroll);
+
+    /// Return whether the content is cached in a texture while scrolling
+    bool cacheContent() const { return mCacheContent; }
+    /**
+     * \brief Cache the rendered content in a texture while scrolling
+     *
+     * When enabled, scroll events render the visible part of the child along
+     * with a margin of one panel height above and below into an offscreen
+     * texture. Until any widget within the child is invalidated again (see
+     * \ref Widget::invalidate()) or the visible part leaves that band,
+     * frames draw the texture instead of the widgets. The texture is
+     * rendered at most once per frame, and not at all while the content
+     * keeps changing from frame to frame, which is then drawn directly.
+     */
+    void setCacheContent(bool cacheContent);
+
     virtual void performLayout(NVGcontext *ctx) override;
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
     virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
@@ -34,10 +58,37 @@ public:
     virtual void draw(NVGcontext *ctx) override;
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
+protected:
+    virtual ~VScrollPanel();
+
+    virtual void descendantInvalidated() override;
+
+    /// Move the child according to the scroll position
+    void updateChildPosition();
+
+    /// Return whether the cache texture is valid and covers the visible part of the child
+    bool cacheCoversView() const;
+
+    /// Render the cache texture again, if this is worthwhile
+    void updateCache();
+
+    /// Render the band around the visible part of the child into the cache texture; returns whether this succeeded
+    bool renderCache();
+
+    /// Release the cache texture
+    void freeCache();
+
 protected:
     int mChildPreferredHeight;
     float mScroll;
-    bool mUpdateLayout;
+    bool mCacheContent, mCacheValid, mMovingChild;
+    /* Whether the content changed since the last frame / during the frame
+       before it, and whether the cache was rendered since the last frame */
+    bool mContentChanged, mContentStable, mCacheRendered;
+    NVGLUframebuffer *mCache;
+    Vector2i mCacheSize;
+    /* Vertical range of the child (in its coordinates) held by the cache */
+    int mCacheTop, mCacheHeight;
 };
 
 NAMESPACE_END(nanogui)
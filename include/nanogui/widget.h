@@ -13,11 +13,49 @@
 #pragma once
 
 #include <nanogui/object.h>
+#include <nanogui/widgetlist.h>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 NAMESPACE_BEGIN(nanogui)
 
 enum class Cursor;// do not put a docstring, this is already documented
+struct HitGrid;
+
+/**
+ * \class ClipScope widget.h nanogui/widget.h
+ *
+ * \brief Restricts drawing to a rectangle for the lifetime of the object.
+ *
+ * The constructor saves the NanoVG state and intersects its scissor with the
+ * given rectangle, which is specified in the current coordinate system; the
+ * destructor restores the state. In addition, the rectangle is recorded for
+ * the draw traversal, so that \ref Widget::draw() skips children that lie
+ * entirely outside of it. Widgets that clip their children (like \ref
+ * VScrollPanel) should use this class instead of \c nvgIntersectScissor().
+ */
+class NANOGUI_EXPORT ClipScope {
+public:
+    ClipScope(NVGcontext *ctx, const Vector2f &pos, const Vector2f &size);
+    ~ClipScope();
+
+    /**
+     * \brief Return the rectangle that is visible in the current draw traversal,
+     * given in the current coordinate system of \c ctx
+     *
+     * Outside of a \ref ClipScope, the rectangle is unbounded.
+     */
+    static void bounds(NVGcontext *ctx, Vector2f &min, Vector2f &max);
+
+private:
+    ClipScope(const ClipScope &) = delete;
+    ClipScope &operator=(const ClipScope &) = delete;
+
+    NVGcontext *mContext;
+    /* Recorded rectangle in screen coordinates that was active before */
+    Vector2f mPrevMin, mPrevMax;
+};
 
 /**
  * \class Widget widget.h nanogui/widget.h
@@ -30,22 +68,48 @@ enum class Cursor;// do not put a docstring, this is already documented
  */
 class NANOGUI_EXPORT Widget : public Object {
 public:
+    /**
+     * \brief Tags of the built-in widget classes that are frequently looked
+     * up in the hierarchy (see \ref widget_cast())
+     *
+     * A widget carries the tags of its class and of all its base classes.
+     */
+    enum TypeTag : uint8_t {
+        TypeWindow = 1 << 0,
+        TypePopup  = 1 << 1,
+        TypeScreen = 1 << 2,
+        TypeLabel  = 1 << 3,
+        TypeButton = 1 << 4
+    };
+
     /// Construct a new widget with the given parent widget
     Widget(Widget *parent);
 
+    /// Allocate a widget on the heap
+    static void *operator new(size_t size) { return ::operator new(size); }
+    /// Allocate a widget from the given pool (or on the heap, if \c pool is \c nullptr)
+    static void *operator new(size_t size, WidgetPool *pool);
+    /// Release the memory of a widget, which may have been allocated from a \ref WidgetPool
+    static void operator delete(void *ptr, size_t size);
+    /// Release the memory of a pooled widget whose constructor has thrown an exception
+    static void operator delete(void *ptr, WidgetPool *pool);
+
     /// Return the parent widget
     Widget *parent() { return mParent; }
     /// Return the parent widget
     const Widget *parent() const { return mParent; }
-    /// Set the parent widget
-    void setParent(Widget *parent) { mParent = parent; }
+    /// Set the parent widget, which updates the cached \ref window() and \ref screen() of the subtree
+    void setParent(Widget *parent);
+
+    /// Return whether the widget is an instance of the class with the given tag
+    bool hasType(TypeTag tag) const { return (mTypeTags & tag) != 0; }
 
     /// Return the used \ref Layout generator
     Layout *layout() { return mLayout; }
     /// Return the used \ref Layout generator
     const Layout *layout() const { return mLayout.get(); }
     /// Set the used \ref Layout generator
-    void setLayout(Layout *layout) { mLayout = layout; }
+    void setLayout(Layout *layout) { mLayout = layout; invalidatePreferredSize(); }
 
     /// Return the \ref Theme used to draw this widget
     Theme *theme() { return mTheme; }
@@ -57,28 +121,48 @@ public:
     /// Return the position relative to the parent widget
     const Vector2i &position() const { return mPos; }
     /// Set the position relative to the parent widget
-    void setPosition(const Vector2i &pos) { mPos = pos; }
-
-    /// Return the absolute position on screen
-    Vector2i absolutePosition() const {
-        return mParent ?
-            (parent()->absolutePosition() + mPos) : mPos;
+    void setPosition(const Vector2i &pos) {
+        if (mPos == pos)
+            return;
+        invalidate();
+        mPos = pos;
+        invalidateAbsolutePosition();
+        invalidate();
+        if (mParent)
+            mParent->mHitGridDirty = true;
     }
 
+    /**
+     * \brief Return the absolute position on screen
+     *
+     * The result is cached until the position of the widget or of one of its
+     * ancestors changes, or the widget is moved to another parent.
+     */
+    const Vector2i &absolutePosition() const;
+
     /// Return the size of the widget
     const Vector2i &size() const { return mSize; }
     /// set the size of the widget
-    void setSize(const Vector2i &size) { mSize = size; }
+    void setSize(const Vector2i &size) {
+        if (mSize == size)
+            return;
+        invalidate();
+        mSize = size;
+        invalidate();
+        invalidatePreferredSize();
+        if (mParent)
+            mParent->mHitGridDirty = true;
+    }
 
     /// Return the width of the widget
     int width() const { return mSize.x(); }
     /// Set the width of the widget
-    void setWidth(int width) { mSize.x() = width; }
+    void setWidth(int width) { setSize(Vector2i(width, mSize.y())); }
 
     /// Return the height of the widget
     int height() const { return mSize.y(); }
     /// Set the height of the widget
-    void setHeight(int height) { mSize.y() = height; }
+    void setHeight(int height) { setSize(Vector2i(mSize.x(), height)); }
 
     /**
      * \brief Set the fixed size of this widget
@@ -89,7 +173,15 @@ public:
      * size; this is done with a call to \ref setSize or a call to \ref performLayout()
      * in the parent widget.
      */
-    void setFixedSize(const Vector2i &fixedSize) { mFixedSize = fixedSize; }
+    void setFixedSize(const Vector2i &fixedSize) {
+        if (mFixedSize == fixedSize)
+            return;
+        mFixedSize = fixedSize;
+        invalidate();
+        invalidatePreferredSize();
+        if (mParent)
+            mParent->invalidateLayout();
+    }
 
     /// Return the fixed size (see \ref setFixedSize())
     const Vector2i &fixedSize() const { return mFixedSize; }
@@ -99,14 +191,38 @@ public:
     // Return the fixed height (see \ref setFixedSize())
     int fixedHeight() const { return mFixedSize.y(); }
     /// Set the fixed width (see \ref setFixedSize())
-    void setFixedWidth(int width) { mFixedSize.x() = width; }
+    void setFixedWidth(int width) { setFixedSize(Vector2i(width, mFixedSize.y())); }
     /// Set the fixed height (see \ref setFixedSize())
-    void setFixedHeight(int height) { mFixedSize.y() = height; }
+    void setFixedHeight(int height) { setFixedSize(Vector2i(mFixedSize.x(), height)); }
 
     /// Return whether or not the widget is currently visible (assuming all parents are visible)
     bool visible() const { return mVisible; }
     /// Set whether or not the widget is currently visible (assuming all parents are visible)
-    void setVisible(bool visible) { mVisible = visible; }
+    void setVisible(bool visible) {
+        if (mVisible == visible)
+            return;
+        mVisible = visible;
+        invalidate(true);
+        invalidatePreferredSize();
+        if (mParent) {
+            mParent->invalidateLayout();
+            mParent->mHitGridDirty = true;
+        }
+    }
+
+    /// Return whether the layout of the parent widget ignores this widget
+    bool excludedFromLayout() const { return mExcludedFromLayout; }
+    /// Set whether the layout of the parent widget ignores this widget, which is then placed by the parent itself
+    void setExcludedFromLayout(bool excluded) {
+        if (mExcludedFromLayout == excluded)
+            return;
+        mExcludedFromLayout = excluded;
+        invalidatePreferredSize();
+        if (mParent)
+            mParent->invalidateLayout();
+    }
+    /// Return whether the layout of the parent widget places this widget (i.e. it is visible and not excluded)
+    bool inLayout() const { return mVisible && !mExcludedFromLayout; }
 
     /// Check if this widget is currently visible, taking parent widgets into account
     bool visibleRecursive() const {
@@ -122,8 +238,13 @@ public:
     /// Return the number of child widgets
     int childCount() const { return (int) mChildren.size(); }
 
-    /// Return the list of child widgets of the current widget
-    const std::vector<Widget *> &children() const { return mChildren; }
+    /**
+     * \brief Return the list of child widgets of the current widget
+     *
+     * The list provides the read-only interface of \c std::vector and
+     * converts to one, which is what this function returned before.
+     */
+    const WidgetList &children() const { return mChildren; }
 
     /**
      * \brief Add a child widget to the current widget at
@@ -138,12 +259,30 @@ public:
     /// Convenience function which appends a widget at the end
     void addChild(Widget *widget);
 
-    /// Remove a child widget by index
+    /**
+     * \brief Insert several widgets (which must not have a parent yet) at
+     * the specified index
+     *
+     * In contrast to repeated calls to \ref addChild(), the existing children
+     * are only moved once, and the ancestors are only invalidated once.
+     */
+    void addChildren(int index, const std::vector<Widget *> &widgets);
+
+    /// Remove a child widget by index, which detaches it from this widget and its ancestors
     void removeChild(int index);
 
-    /// Remove a child widget by value
+    /**
+     * \brief Remove a child widget by value
+     *
+     * The index of the child is usually known in constant time. It is
+     * recomputed for all children after an earlier removal has moved the
+     * widget, hence removing children from the back is cheapest.
+     */
     void removeChild(const Widget *widget);
 
+    /// Remove all child widgets at once (see \ref removeChild())
+    void clearChildren();
+
     /// Retrieves the child at the specific position
     const Widget* childAt(int index) const { return mChildren[index]; }
 
@@ -153,39 +292,74 @@ public:
     /// Returns the index of a specific child or -1 if not found
     int childIndex(Widget* widget) const;
 
-    /// Variadic shorthand notation to construct and add a child widget
+    /// Variadic shorthand notation to construct and add a child widget (allocated from \ref widgetPool())
     template<typename WidgetClass, typename... Args>
     WidgetClass* add(const Args&... args) {
-        return new WidgetClass(this, args...);
+        return new (widgetPool()) WidgetClass(this, args...);
     }
 
-    /// Walk up the hierarchy and return the parent window
+    /// Return the pool of the window containing this widget, or \c nullptr if it has none
+    WidgetPool *widgetPool();
+
+    /// Return the window containing this widget (or the widget itself, if it is a window)
     Window *window();
 
-    /// Associate this widget with an ID value (optional)
-    void setId(const std::string &id) { mId = id; }
+    /// Return the screen (or \c nullptr if not attached to one)
+    Screen *screen();
+
+    /// Associate this widget with an ID value (optional, see \ref Screen::findById())
+    void setId(const std::string &id);
     /// Return the ID value associated with this widget, if any
-    const std::string &id() const { return mId; }
+    const std::string &id() const;
 
     /// Return whether or not this widget is currently enabled
     bool enabled() const { return mEnabled; }
     /// Set whether or not this widget is currently enabled
-    void setEnabled(bool enabled) { mEnabled = enabled; }
+    void setEnabled(bool enabled) { mEnabled = enabled; invalidate(); }
 
     /// Return whether or not this widget is currently focused
     bool focused() const { return mFocused; }
     /// Set whether or not this widget is currently focused
-    void setFocused(bool focused) { mFocused = focused; }
+    void setFocused(bool focused) { mFocused = focused; invalidate(); }
     /// Request the focus to be moved to this widget
     void requestFocus();
 
-    const std::string &tooltip() const { return mTooltip; }
-    void setTooltip(const std::string &tooltip) { mTooltip = tooltip; }
+    /**
+     * \brief Mark the area covered by this widget as needing a redraw
+     *
+     * The area is reported to the \ref Screen containing this widget, which
+     * may restrict the next repaint to it (see \ref Screen::setPartialRedraw()).
+     * Pass \c force to damage the area even if the widget is hidden.
+     *
+     * The setters of the built-in widgets and the event handlers of \ref
+     * Screen call this automatically. Custom widgets should invoke it whenever
+     * they change state that affects their appearance outside of these paths
+     * (e.g. an animation driven from \ref draw() or a modification made
+     * through a non-const accessor such as \ref Graph::values()).
+     */
+    void invalidate(bool force = false);
+
+    /**
+     * \brief Invalidate this widget after \c delay seconds
+     *
+     * Use this for time-based effects such as animations or blinking, which
+     * allows \ref mainloop() to sleep until the next frame is actually due.
+     */
+    void scheduleRedraw(double delay);
+
+    const std::string &tooltip() const;
+    void setTooltip(const std::string &tooltip);
 
     /// Return current font size. If not set the default of the current theme will be returned
     int fontSize() const;
     /// Set the font size of this widget
-    void setFontSize(int fontSize) { mFontSize = fontSize; }
+    void setFontSize(int fontSize) {
+        if (mFontSize == fontSize)
+            return;
+        mFontSize = fontSize;
+        invalidate();
+        invalidatePreferredSize();
+    }
     /// Return whether the font size is explicitly specified for this widget
     bool hasFontSize() const { return mFontSize > 0; }
 
@@ -230,34 +404,175 @@ public:
     /// Compute the preferred size of the widget
     virtual Vector2i preferredSize(NVGcontext *ctx) const;
 
+    /**
+     * \brief Return the preferred size of the widget, reusing the result of
+     * an earlier call unless it has since been invalidated
+     *
+     * Layouts and container widgets measure their children using this
+     * function, so that a frame in which nothing changed does not measure
+     * anything. See \ref invalidatePreferredSize().
+     */
+    Vector2i cachedPreferredSize(NVGcontext *ctx) const;
+
+    /**
+     * \brief Discard the cached preferred size of this widget and of all
+     * of its ancestors
+     *
+     * The ancestors are visited up to (and excluding) the first one whose
+     * preferred size does not depend on its children (see \ref
+     * childrenAffectPreferredSize()).
+     *
+     * This also invalidates the layout of the widget (see \ref
+     * invalidateLayout()).
+     *
+     * The setters of \ref Widget and of the built-in widgets call this when
+     * they change a property that affects the preferred size (e.g. caption,
+     * font size, fixed size, layout, visibility or children). Custom widgets
+     * whose \ref preferredSize() depends on further state must call it when
+     * that state changes, and so must code that modifies the parameters of a
+     * \ref Layout that is already in use.
+     */
+    void invalidatePreferredSize();
+
+    /**
+     * \brief Request the children of this widget to be arranged again by the
+     * next call to \ref updateLayout()
+     *
+     * Called when the child list or layout generator of the widget changes,
+     * when a child is shown, hidden or given a different fixed size, and via
+     * \ref invalidatePreferredSize().
+     */
+    void invalidateLayout();
+
+    /**
+     * \brief Lay out the parts of this subtree that changed since they were
+     * last laid out
+     *
+     * This descends only into subtrees containing widgets whose layout was
+     * invalidated. A widget is laid out again with \ref performLayout() if
+     * its own layout was invalidated, or if one of its children now reports a
+     * different preferred size than during the previous layout; otherwise,
+     * the search continues in its children. Unchanged parts of the widget
+     * tree are therefore neither measured nor laid out.
+     */
+    void updateLayout(NVGcontext *ctx);
+
     /// Invoke the associated layout generator to properly place child widgets, if any
     virtual void performLayout(NVGcontext *ctx);
 
-    /// Draw the widget (and all child widgets)
+    /**
+     * \brief Draw the widget (and all child widgets)
+     *
+     * Children that lie entirely outside of the rectangle of the enclosing
+     * \ref ClipScope objects are skipped, along with their descendants.
+     */
     virtual void draw(NVGcontext *ctx);
 
     /// Save the state of the widget into the given \ref Serializer instance
     virtual void save(Serializer &s) const;
 
-    /// Restore the state of the widget from the given \ref Serializer instance
+    /**
+     * \brief Restore the state of the widget from the given \ref Serializer instance
+     *
+     * The cached preferred size, the layout and the drawn area of the widget
+     * are invalidated as if the setters had been called.
+     */
     virtual bool load(Serializer &s);
 
 protected:
     /// Free all resources used by the widget and any children
     virtual ~Widget();
 
+    /**
+     * \brief Return the visible children that may contain \c p0 or \c p1
+     * (given in the coordinate system of this widget), topmost first
+     *
+     * Widgets with many children answer this query from a uniform grid over
+     * the child rectangles, which is rebuilt lazily after a child has been
+     * added, removed, moved, resized, shown or hidden.
+     */
+    void childrenAt(const Vector2i &p0, const Vector2i &p1, std::vector<Widget *> &result);
+
+    /// Return the spatial index over the children, or \c nullptr if there are only a few
+    const HitGrid *hitGrid();
+
+    /// Mark this widget and its descendants as laid out (see \ref updateLayout())
+    void clearLayoutDirty();
+
+    /**
+     * \brief Called by \ref invalidate() on every ancestor of the invalidated
+     * widget, e.g. to discard a cached rendering of the subtree
+     */
+    virtual void descendantInvalidated() { }
+
+    /**
+     * \brief Return whether the preferred size of this widget depends on its
+     * children
+     *
+     * If not, \ref invalidatePreferredSize() stops at this widget when it is
+     * called by a descendant, which e.g. lets a \ref ListView recycle its rows
+     * without measuring the entire window again.
+     */
+    virtual bool childrenAffectPreferredSize() const { return true; }
+
+    /// Refresh the cached window and screen of this widget and its descendants
+    void updateAncestors();
+
+    /// Discard the cached absolute position of this widget and its descendants
+    void invalidateAbsolutePosition();
+
+    /// Strings that most widgets do not have, which are only allocated once set
+    struct Annotations {
+        std::string id;
+        std::string tooltip;
+    };
+
+    /// Return the annotations, creating them if necessary
+    Annotations &annotations();
+
 protected:
+    /* The flags come first to occupy the padding at the end of Object */
+    uint8_t mTypeTags;
+    bool mVisible : 1, mEnabled : 1;
+    bool mFocused : 1, mMouseFocus : 1;
+    bool mHitGridDirty : 1;
+    bool mLayoutDirty : 1, mSubtreeLayoutDirty : 1;
+    /// Whether the widget was allocated from a \ref WidgetPool
+    bool mPooled : 1;
+    /* Not packed with the flags above, since they are updated by const
+       methods that may run on layout threads (see Screen::setLayoutThreads()) */
+    mutable bool mPreferredSizeValid;
+    mutable bool mAbsolutePosValid;
     Widget *mParent;
+    /* Nearest window and screen among the (strict) ancestors */
+    Window *mWindow;
+    Screen *mScreen;
     ref<Theme> mTheme;
     ref<Layout> mLayout;
-    std::string mId;
+    std::unique_ptr<Annotations> mAnnotations;
     Vector2i mPos, mSize, mFixedSize;
-    std::vector<Widget *> mChildren;
-    bool mVisible, mEnabled;
-    bool mFocused, mMouseFocus;
-    std::string mTooltip;
+    mutable Vector2i mAbsolutePos;
+    mutable Vector2i mPreferredSize;
+    Vector2i mLayoutPreferredSize;
+    WidgetList mChildren;
     int mFontSize;
     Cursor mCursor;
+    /* Position in the parent's list of children, if that hasn't changed since */
+    mutable uint32_t mIndexInParent;
+    /* Kept apart from the flags above, where it would enlarge the widget */
+    bool mExcludedFromLayout;
+    std::unique_ptr<HitGrid> mHitGrid;
 };
 
+/**
+ * \brief Cast a widget to one of the tagged classes (see \ref Widget::TypeTag)
+ *
+ * This is equivalent to \c dynamic_cast, but merely tests a flag. Returns
+ * \c nullptr if the widget is not an instance of \c T.
+ */
+template <typename T, typename W> T *widget_cast(W *widget) {
+    return widget && widget->hasType(std::remove_const<T>::type::StaticTypeTag)
+        ? static_cast<T *>(widget) : nullptr;
+}
+
 NAMESPACE_END(nanogui)
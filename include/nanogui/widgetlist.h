@@ -0,0 +1,154 @@
+/*
+    nanogui/widgetlist.h -- Compact list of child widgets that stores up
+    to two entries without a heap allocation
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class WidgetList widgetlist.h nanogui/widgetlist.h
+ *
+ * \brief Sequence of widget pointers used to store the children of a \ref Widget.
+ *
+ * Most widgets of a large user interface are leaves or have very few
+ * children. The list therefore stores up to two pointers inline and only
+ * allocates memory on the heap for more entries. It occupies as much space
+ * as a \c std::vector and provides its read-only interface; iterators are
+ * plain pointers. Code written for the former <tt>const std::vector<Widget
+ * *> &</tt> type of \ref Widget::children() continues to compile, since the
+ * list converts to a \c std::vector (by copying it) where one is required.
+ */
+class WidgetList {
+public:
+    using value_type = Widget *;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = Widget *&;
+    using const_reference = Widget *const &;
+    using iterator = Widget **;
+    using const_iterator = Widget *const *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    WidgetList() : mSize(0), mCapacity(InlineCapacity) { }
+    WidgetList(const WidgetList &) = delete;
+    WidgetList &operator=(const WidgetList &) = delete;
+    ~WidgetList() { if (!isInline()) delete[] mHeap; }
+
+    size_t size() const { return mSize; }
+    size_t capacity() const { return mCapacity; }
+    bool empty() const { return mSize == 0; }
+
+    Widget **data() { return isInline() ? mInline : mHeap; }
+    Widget *const *data() const { return isInline() ? mInline : mHeap; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + mSize; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + mSize; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    Widget *&operator[](size_t index) { return data()[index]; }
+    Widget *operator[](size_t index) const { return data()[index]; }
+    Widget *&front() { return data()[0]; }
+    Widget *front() const { return data()[0]; }
+    Widget *&back() { return data()[mSize - 1]; }
+    Widget *back() const { return data()[mSize - 1]; }
+
+    Widget *at(size_t index) const {
+        if (index >= mSize)
+            throw std::out_of_range("WidgetList::at(): index out of range!");
+        return data()[index];
+    }
+
+    /// Copy the widgets into a \c std::vector
+    operator std::vector<Widget *>() const { return std::vector<Widget *>(begin(), end()); }
+
+    /// Insert a widget before the given position
+    iterator insert(const_iterator pos, Widget *widget) {
+        size_t index = pos - data();
+        if (mSize == mCapacity)
+            reserve(2 * mCapacity);
+        Widget **d = data();
+        std::move_backward(d + index, d + mSize, d + mSize + 1);
+        d[index] = widget;
+        mSize++;
+        return d + index;
+    }
+
+    /// Insert a range of widgets before the given position, moving the subsequent ones only once
+    template <typename Iterator>
+    iterator insert(const_iterator pos, Iterator first, Iterator last) {
+        size_t index = pos - data(), count = (size_t) std::distance(first, last);
+        if (mSize + count > mCapacity)
+            reserve(std::max(mSize + count, 2 * (size_t) mCapacity));
+        Widget **d = data();
+        std::move_backward(d + index, d + mSize, d + mSize + count);
+        std::copy(first, last, d + index);
+        mSize += (uint32_t) count;
+        return d + index;
+    }
+
+    void push_back(Widget *widget) { insert(end(), widget); }
+
+    /// Remove the widgets in the range [first, last)
+    iterator erase(const_iterator first, const_iterator last) {
+        Widget **d = data();
+        size_t i = first - d, j = last - d;
+        std::move(d + j, d + mSize, d + i);
+        mSize -= (uint32_t) (j - i);
+        return d + i;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    void clear() { mSize = 0; }
+
+    /// Make room for at least the given number of widgets
+    void reserve(size_t capacity) {
+        if (capacity <= mCapacity)
+            return;
+        Widget **heap = new Widget *[capacity];
+        std::copy(begin(), end(), heap);
+        if (!isInline())
+            delete[] mHeap;
+        mHeap = heap;
+        mCapacity = (uint32_t) capacity;
+    }
+
+private:
+    static constexpr uint32_t InlineCapacity = 2;
+
+    bool isInline() const { return mCapacity == InlineCapacity; }
+
+    union {
+        Widget **mHeap;
+        Widget *mInline[InlineCapacity];
+    };
+    uint32_t mSize, mCapacity;
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,72 @@
+/*
+    nanogui/widgetpool.h -- Pool allocator for the widgets of a window
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class WidgetPool widgetpool.h nanogui/widgetpool.h
+ *
+ * \brief Allocates widgets from large chunks of memory.
+ *
+ * Freed blocks are kept on one free list per size class and handed out again
+ * when widgets of a similar size are created, so that repeatedly rebuilding a
+ * panel with many widgets does not churn the general-purpose allocator. Memory
+ * is only returned to the system once the pool is destroyed, which happens
+ * after the last reference to it and the last widget allocated from it are
+ * gone.
+ *
+ * A pool is attached to a window using \ref Window::setWidgetPool(), after
+ * which \ref Widget::add() allocates the widgets of that window from it.
+ * Widgets may also be allocated explicitly using <tt>new (pool) Label(...)</tt>.
+ * Pools must only be used on the thread running the main loop.
+ */
+class NANOGUI_EXPORT WidgetPool : public Object {
+public:
+    /// Create a pool that requests memory in chunks of the given size
+    WidgetPool(size_t chunkSize = 64 * 1024);
+
+    /// Allocate a block of the given size (larger blocks are taken from the heap)
+    void *allocate(size_t size);
+
+    /// Return a block that was allocated with the given size to its free list
+    void deallocate(void *ptr, size_t size);
+
+    /// Return the number of chunks allocated so far
+    size_t chunkCount() const { return mChunks.size(); }
+
+    /// Return the number of blocks that are currently in use
+    size_t blockCount() const { return mBlockCount; }
+
+protected:
+    /// Release all chunks
+    virtual ~WidgetPool();
+
+    static const size_t Granularity = 16;
+    static const size_t MaxBlockSize = 1024;
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    size_t mChunkSize;
+    std::vector<char *> mChunks;
+    char *mCursor, *mEnd;
+    FreeBlock *mFree[MaxBlockSize / Granularity];
+    size_t mBlockCount;
+};
+
+NAMESPACE_END(nanogui)
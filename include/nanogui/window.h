@@ -13,6 +13,7 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <nanogui/widgetpool.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -22,14 +23,19 @@ NAMESPACE_BEGIN(nanogui)
  * \brief Top-level window widget.
  */
 class NANOGUI_EXPORT Window : public Widget {
+    friend class Widget;
     friend class Popup;
+    friend class Screen;
 public:
+    /// Tag identifying this class (see \ref widget_cast())
+    static constexpr TypeTag StaticTypeTag = TypeWindow;
+
     Window(Widget *parent, const std::string &title = "Untitled");
 
     /// Return the window title
     const std::string &title() const { return mTitle; }
     /// Set the window title
-    void setTitle(const std::string &title) { mTitle = title; }
+    void setTitle(const std::string &title) { mTitle = title; invalidate(); invalidatePreferredSize(); }
 
     /// Is this a model dialog?
     bool modal() const { return mModal; }
@@ -39,6 +45,17 @@ public:
     /// Return the panel used to house window buttons
     Widget *buttonPanel();
 
+    /// Return the popups attached to this window, which are kept in front of it
+    const std::vector<Popup *> &popups() const { return mPopups; }
+
+    /**
+     * \brief Allocate the widgets that are subsequently created in this window
+     * using \ref Widget::add() from the given pool (\c nullptr disables pooling)
+     *
+     * Popups attached to the window later on share its pool.
+     */
+    void setWidgetPool(WidgetPool *pool) { mWidgetPool = pool; }
+
     /// Dispose the window
     void dispose();
 
@@ -60,13 +77,25 @@ public:
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
 protected:
-    /// Internal helper function to maintain nested window position values; overridden in \ref Popup
+    /// Detach the popups that refer to this window
+    virtual ~Window();
+
+    /**
+     * \brief Place the attached popups (and theirs, recursively) next to
+     * this window
+     *
+     * Called when the window is dragged, and by \ref Screen::drawAll() after
+     * the layout has been updated. Overridden in \ref Popup, which also places
+     * itself next to its parent window.
+     */
     virtual void refreshRelativePlacement();
 protected:
     std::string mTitle;
     Widget *mButtonPanel;
     bool mModal;
     bool mDrag;
+    std::vector<Popup *> mPopups;
+    ref<WidgetPool> mWidgetPool;
 };
 
 NAMESPACE_END(nanogui)
@@ -33,8 +33,9 @@ void register_widget(py::module &m) {
         .def("visible", &Widget::visible, D(Widget, visible))
         .def("setVisible", &Widget::setVisible, D(Widget, setVisible))
         .def("visibleRecursive", &Widget::visibleRecursive, D(Widget, visibleRecursive))
-        .def("children", (std::vector<Widget *>&(Widget::*)(void)) &Widget::children,
-             D(Widget, children), py::return_value_policy::reference)
+        .def("children", [](const Widget &w) {
+                return std::vector<Widget *>(w.children().begin(), w.children().end());
+            }, D(Widget, children), py::return_value_policy::reference)
         .def("addChild", (void (Widget::*) (int, Widget *)) &Widget::addChild, D(Widget, addChild))
         .def("addChild", (void (Widget::*) (Widget *)) &Widget::addChild, D(Widget, addChild, 2))
         .def("childCount", &Widget::childCount, D(Widget, childCount))
@@ -12,6 +12,7 @@
 #include <nanogui/button.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textlayout.h>
 #include <nanogui/serializer/core.h>
 
 NAMESPACE_BEGIN(nanogui)
@@ -20,23 +21,25 @@ Button::Button(Widget *parent, const std::string &caption, int icon)
     : Widget(parent), mCaption(caption), mIcon(icon),
       mIconPosition(IconPosition::LeftCentered), mPushed(false),
       mFlags(NormalButton), mBackgroundColor(Color(0, 0)),
-      mTextColor(Color(0, 0)) { }
+      mTextColor(Color(0, 0)) {
+    mTypeTags |= TypeButton;
+}
 
 Vector2i Button::preferredSize(NVGcontext *ctx) const {
     int fontSize = mFontSize == -1 ? mTheme->mButtonFontSize : mFontSize;
-    nvgFontSize(ctx, fontSize);
-    nvgFontFace(ctx, "sans-bold");
-    float tw = nvgTextBounds(ctx, 0,0, mCaption.c_str(), nullptr, nullptr);
+    TextLayoutCache &cache = TextLayoutCache::instance();
+    float tw = cache.layout("sans-bold", fontSize, mCaption)->size.x();
     float iw = 0.0f, ih = fontSize;
 
     if (mIcon) {
         if (nvgIsFontIcon(mIcon)) {
             ih *= 1.5f;
-            nvgFontFace(ctx, "icons");
-            nvgFontSize(ctx, ih);
-            iw = nvgTextBounds(ctx, 0, 0, utf8(mIcon).data(), nullptr, nullptr)
+            iw = cache.layout("icons", ih, utf8(mIcon).data())->size.x()
                 + mSize.y() * 0.15f;
         } else {
+            if (!ctx)
+                throw std::runtime_error("Button::preferredSize(): image icons "
+                                         "can only be measured using a NanoVG context!");
             int w, h;
             ih *= 0.9f;
             nvgImageSize(ctx, mIcon, &w, &h);
@@ -58,7 +61,7 @@ bool Button::mouseButtonEvent(const Vector2i &p, int button, bool down, int modi
             if (mFlags & RadioButton) {
                 if (mButtonGroup.empty()) {
                     for (auto widget : parent()->children()) {
-                        Button *b = dynamic_cast<Button *>(widget);
+                        Button *b = widget_cast<Button>(widget);
                         if (b != this && b && (b->flags() & RadioButton) && b->mPushed) {
                             b->mPushed = false;
                             if (b->mChangeCallback)
@@ -77,7 +80,7 @@ bool Button::mouseButtonEvent(const Vector2i &p, int button, bool down, int modi
             }
             if (mFlags & PopupButton) {
                 for (auto widget : parent()->children()) {
-                    Button *b = dynamic_cast<Button *>(widget);
+                    Button *b = widget_cast<Button>(widget);
                     if (b != this && b && (b->flags() & PopupButton) && b->mPushed) {
                         b->mPushed = false;
                         if (b->mChangeCallback)
@@ -152,6 +155,8 @@ void Button::draw(NVGcontext *ctx) {
     nvgStrokeColor(ctx, mTheme->mBorderDark);
     nvgStroke(ctx);
 
+    /* The caption is centered using the metrics of NanoVG, which rasterizes
+       text at the scale of the framebuffer (unlike TextLayoutCache) */
     int fontSize = mFontSize == -1 ? mTheme->mButtonFontSize : mFontSize;
     nvgFontSize(ctx, fontSize);
     nvgFontFace(ctx, "sans-bold");
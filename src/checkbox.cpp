@@ -12,6 +12,7 @@
 #include <nanogui/checkbox.h>
 #include <nanogui/opengl.h>
 #include <nanogui/theme.h>
+#include <nanogui/fontmetrics.h>
 #include <nanogui/entypo.h>
 #include <nanogui/serializer/core.h>
 
@@ -44,13 +45,11 @@ bool CheckBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
     return false;
 }
 
-Vector2i CheckBox::preferredSize(NVGcontext *ctx) const {
+Vector2i CheckBox::preferredSize(NVGcontext *) const {
     if (mFixedSize != Vector2i::Zero())
         return mFixedSize;
-    nvgFontSize(ctx, fontSize());
-    nvgFontFace(ctx, "sans");
     return Vector2i(
-        nvgTextBounds(ctx, 0, 0, mCaption.c_str(), nullptr, nullptr) +
+        FontMetrics::instance().textWidth("sans", fontSize(), mCaption) +
             1.7f * fontSize(),
         fontSize() * 1.3f);
 }
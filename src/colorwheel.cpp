@@ -302,6 +302,7 @@ void ColorWheel::setColor(const Color &rgb) {
         mBlack = bary[1];
         mWhite = bary[2];
     }
+    invalidate();
 }
 
 void ColorWheel::save(Serializer &s) const {
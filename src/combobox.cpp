@@ -32,7 +32,7 @@ ComboBox::ComboBox(Widget *parent, const std::vector<std::string> &items, const
 void ComboBox::setSelectedIndex(int idx) {
     if (mItemsShort.empty())
         return;
-    const std::vector<Widget *> &children = popup()->children();
+    const WidgetList &children = popup()->children();
     ((Button *) children[mSelectedIndex])->setPushed(false);
     ((Button *) children[idx])->setPushed(true);
     mSelectedIndex = idx;
@@ -45,12 +45,11 @@ void ComboBox::setItems(const std::vector<std::string> &items, const std::vector
     mItemsShort = itemsShort;
     if (mSelectedIndex < 0 || mSelectedIndex >= (int) items.size())
         mSelectedIndex = 0;
-    while (mPopup->childCount() != 0)
-        mPopup->removeChild(mPopup->childCount()-1);
+    mPopup->clearChildren();
     mPopup->setLayout(new GroupLayout(10));
     int index = 0;
     for (const auto &str: items) {
-        Button *button = new Button(mPopup, str);
+        Button *button = mPopup->add<Button>(str);
         button->setFlags(Button::RadioButton);
         button->setCallback([&, index] {
             mSelectedIndex = index;
@@ -17,8 +17,8 @@
 
 #include <nanogui/opengl.h>
 #include <map>
-#include <thread>
-#include <chrono>
+#include <limits>
+#include <cmath>
 #include <iostream>
 
 #if !defined(_WIN32)
@@ -59,36 +59,45 @@ void mainloop(int refresh) {
 
     mainloop_active = true;
 
-    std::thread refresh_thread;
-    if (refresh > 0) {
-        /* If there are no mouse/keyboard events, try to refresh the
-           view roughly every 50 ms (default); this is to support animations
-           such as progress bars while keeping the system load
-           reasonably low */
-        refresh_thread = std::thread(
-            [refresh]() {
-                std::chrono::milliseconds time(refresh);
-                while (mainloop_active) {
-                    std::this_thread::sleep_for(time);
-                    glfwPostEmptyEvent();
-                }
-            }
-        );
-    }
-
     try {
         while (mainloop_active) {
             int numScreens = 0;
+            /* Wall-clock time (glfwGetTime()) at which to wake up again */
+            double deadline = std::numeric_limits<double>::infinity();
+
             for (auto kv : __nanogui_screens) {
                 Screen *screen = kv.second;
-                if (!screen->visible()) {
+                /* Headless screens are driven by the application */
+                if (!screen->visible() || screen->headless()) {
                     continue;
                 } else if (glfwWindowShouldClose(screen->glfwWindow())) {
                     screen->setVisible(false);
                     continue;
                 }
-                screen->drawAll();
+                /* Deadlines are expressed in the time base of the screen,
+                   which may have been replaced using Screen::setClock() */
+                double now = screen->time();
+                screen->processTasks();
+                screen->processDeadlines(now);
+                /* Coalesced motion only damages the screen once dispatched */
+                screen->flushMotionEvents();
+                /* Skip screens whose contents have not changed */
+                if (screen->needsRedraw())
+                    screen->drawAll();
                 numScreens++;
+
+                /* Determine when the next frame is due. Screens that were
+                   invalidated while drawing (i.e. animated contents that
+                   did not schedule a deadline) are refreshed periodically */
+                double next = screen->nextDeadline();
+                if (screen->needsRedraw() && refresh > 0)
+                    next = std::min(next, now + refresh / 1000.0);
+                /* Continue right away if the task budget was exhausted */
+                if (screen->hasPendingTasks())
+                    next = now;
+                /* Convert the remaining time to the wall clock */
+                if (!std::isinf(next))
+                    deadline = std::min(deadline, glfwGetTime() + (next - screen->time()));
             }
 
             if (numScreens == 0) {
@@ -97,8 +106,11 @@ void mainloop(int refresh) {
                 break;
             }
 
-            /* Wait for mouse/keyboard or empty refresh events */
-            glfwWaitEvents();
+            /* Wait for mouse/keyboard or empty events, or the next deadline */
+            if (std::isinf(deadline))
+                glfwWaitEvents();
+            else
+                glfwWaitEventsTimeout(std::max(deadline - glfwGetTime(), 0.0));
         }
 
         /* Process events once more */
@@ -107,9 +119,6 @@ void mainloop(int refresh) {
         std::cerr << "Caught exception in main loop: " << e.what() << std::endl;
         abort();
     }
-
-    if (refresh > 0)
-        refresh_thread.join();
 }
 
 void leave() {
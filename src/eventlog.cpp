@@ -0,0 +1,219 @@
+/*
+    src/eventlog.cpp -- Recording and deterministic replay of the input
+    events received by a screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/eventlog.h>
+#include <nanogui/screen.h>
+#include <cstring>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Log layout (native byte order): the magic string and a version number,
+   followed by one record per event consisting of the event type (uint8),
+   its time (double) and a type-dependent payload */
+static const char eventLogMagic[4] = { 'N', 'G', 'E', 'V' };
+static const uint32_t eventLogVersion = 1;
+
+template <typename T> static void write(std::ostream &os, const T &value) {
+    os.write((const char *) &value, sizeof(T));
+}
+
+template <typename T> static void read(std::istream &is, T &value) {
+    is.read((char *) &value, sizeof(T));
+}
+
+EventRecorder::EventRecorder(const std::string &filename)
+    : mStream(filename, std::ios::binary), mStart(std::chrono::steady_clock::now()),
+      mEventCount(0) {
+    if (!mStream)
+        throw std::runtime_error("EventRecorder: could not open \"" + filename + "\"!");
+    mStream.write(eventLogMagic, sizeof(eventLogMagic));
+    write(mStream, eventLogVersion);
+}
+
+EventRecorder::~EventRecorder() {
+    flush();
+}
+
+void EventRecorder::record(RecordedEvent e) {
+    e.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+
+    write(mStream, (uint8_t) e.type);
+    write(mStream, e.time);
+    switch (e.type) {
+        case RecordedEvent::Type::CursorPos:
+        case RecordedEvent::Type::Scroll:
+            write(mStream, e.x);
+            write(mStream, e.y);
+            break;
+
+        case RecordedEvent::Type::MouseButton:
+            for (int i = 0; i < 3; ++i)
+                write(mStream, (int32_t) e.args[i]);
+            break;
+
+        case RecordedEvent::Type::Key:
+            for (int i = 0; i < 4; ++i)
+                write(mStream, (int32_t) e.args[i]);
+            break;
+
+        case RecordedEvent::Type::Char:
+            write(mStream, (uint32_t) e.args[0]);
+            break;
+
+        case RecordedEvent::Type::Resize:
+            for (int i = 0; i < 2; ++i)
+                write(mStream, (int32_t) e.args[i]);
+            break;
+
+        case RecordedEvent::Type::Drop:
+            write(mStream, (uint32_t) e.filenames.size());
+            for (const std::string &filename : e.filenames) {
+                write(mStream, (uint32_t) filename.size());
+                mStream.write(filename.data(), filename.size());
+            }
+            break;
+    }
+    mEventCount++;
+}
+
+EventPlayer::EventPlayer(const std::string &filename) : mNext(0), mTime(0) {
+    std::ifstream is(filename, std::ios::binary);
+    if (!is)
+        throw std::runtime_error("EventPlayer: could not open \"" + filename + "\"!");
+
+    char magic[4];
+    uint32_t version = 0;
+    is.read(magic, sizeof(magic));
+    read(is, version);
+    if (!is || memcmp(magic, eventLogMagic, sizeof(magic)) != 0 ||
+        version != eventLogVersion)
+        throw std::runtime_error("EventPlayer: \"" + filename +
+                                 "\" is not a valid event log!");
+
+    while (true) {
+        uint8_t type;
+        read(is, type);
+        if (!is)
+            break;
+
+        RecordedEvent e;
+        e.type = (RecordedEvent::Type) type;
+        read(is, e.time);
+        int32_t value;
+        switch (e.type) {
+            case RecordedEvent::Type::CursorPos:
+            case RecordedEvent::Type::Scroll:
+                read(is, e.x);
+                read(is, e.y);
+                break;
+
+            case RecordedEvent::Type::MouseButton:
+                for (int i = 0; i < 3; ++i) {
+                    read(is, value);
+                    e.args[i] = value;
+                }
+                break;
+
+            case RecordedEvent::Type::Key:
+                for (int i = 0; i < 4; ++i) {
+                    read(is, value);
+                    e.args[i] = value;
+                }
+                break;
+
+            case RecordedEvent::Type::Char: {
+                    uint32_t codepoint;
+                    read(is, codepoint);
+                    e.args[0] = (int) codepoint;
+                }
+                break;
+
+            case RecordedEvent::Type::Resize:
+                for (int i = 0; i < 2; ++i) {
+                    read(is, value);
+                    e.args[i] = value;
+                }
+                break;
+
+            case RecordedEvent::Type::Drop: {
+                    uint32_t count = 0, length = 0;
+                    read(is, count);
+                    for (uint32_t i = 0; i < count && is; ++i) {
+                        read(is, length);
+                        std::string filename(length, '\0');
+                        is.read(&filename[0], length);
+                        e.filenames.push_back(filename);
+                    }
+                }
+                break;
+
+            default:
+                throw std::runtime_error("EventPlayer: \"" + filename +
+                                         "\" contains an unknown event type!");
+        }
+
+        if (!is)
+            throw std::runtime_error("EventPlayer: \"" + filename + "\" is truncated!");
+        mEvents.push_back(std::move(e));
+    }
+}
+
+size_t EventPlayer::advance(Screen *screen, double time) {
+    size_t count = 0;
+    while (mNext < mEvents.size() && mEvents[mNext].time <= time) {
+        const RecordedEvent &e = mEvents[mNext++];
+        mTime = e.time;
+        count++;
+
+        switch (e.type) {
+            case RecordedEvent::Type::CursorPos:
+                screen->cursorPosCallbackEvent(e.x, e.y);
+                break;
+
+            case RecordedEvent::Type::MouseButton:
+                screen->mouseButtonCallbackEvent(e.args[0], e.args[1], e.args[2]);
+                break;
+
+            case RecordedEvent::Type::Key:
+                screen->keyCallbackEvent(e.args[0], e.args[1], e.args[2], e.args[3]);
+                break;
+
+            case RecordedEvent::Type::Char:
+                screen->charCallbackEvent((unsigned int) e.args[0]);
+                break;
+
+            case RecordedEvent::Type::Scroll:
+                screen->scrollCallbackEvent(e.x, e.y);
+                break;
+
+            case RecordedEvent::Type::Drop: {
+                    std::vector<const char *> filenames;
+                    for (const std::string &filename : e.filenames)
+                        filenames.push_back(filename.c_str());
+                    screen->dropCallbackEvent((int) filenames.size(), filenames.data());
+                }
+                break;
+
+            case RecordedEvent::Type::Resize: {
+                    /* The size is recorded in screen coordinates */
+                    Vector2i size(e.args[0], e.args[1]);
+                    screen->setSize(size);
+                    screen->resizeCallbackEvent(size.x(), size.y());
+                }
+                break;
+        }
+    }
+    mTime = std::max(mTime, time);
+    return count;
+}
+
+NAMESPACE_END(nanogui)
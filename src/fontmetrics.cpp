@@ -0,0 +1,355 @@
+/*
+    src/fontmetrics.cpp -- Thread-safe text measurement that does not
+    require a NanoVG context
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/fontmetrics.h>
+#include <nanogui/textlayout.h>
+#include <nanogui_resources.h>
+#include <unordered_map>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#if defined(_WIN32)
+#  pragma warning(push)
+#  pragma warning(disable: 4244 4456 4457 4701)
+#endif
+
+/* Private copy of the TrueType parser that ships with NanoVG */
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+#if defined(_WIN32)
+#  pragma warning(pop)
+#endif
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Decode the next code point of a UTF-8 string, skipping malformed sequences */
+static bool nextCodepoint(const char *&it, const char *end, uint32_t &codepoint) {
+    while (it < end) {
+        uint8_t c = (uint8_t) *it++;
+        int extra;
+        if (c < 0x80) {
+            codepoint = c;
+            return true;
+        } else if ((c & 0xE0) == 0xC0) {
+            codepoint = c & 0x1F; extra = 1;
+        } else if ((c & 0xF0) == 0xE0) {
+            codepoint = c & 0x0F; extra = 2;
+        } else if ((c & 0xF8) == 0xF0) {
+            codepoint = c & 0x07; extra = 3;
+        } else {
+            continue;
+        }
+        if (end - it < extra)
+            return false;
+        int i = 0;
+        for (; i < extra && ((uint8_t) it[i] & 0xC0) == 0x80; ++i)
+            codepoint = (codepoint << 6) | ((uint8_t) it[i] & 0x3F);
+        if (i < extra)
+            continue;
+        it += extra;
+        return true;
+    }
+    return false;
+}
+
+/* NanoVG passes font sizes to fontstash in tenths of a pixel */
+static float quantizeSize(float size) {
+    return (int16_t) (size * 10.f) / 10.f;
+}
+
+/* Range of characters whose metrics are tabulated up front */
+static const uint32_t AsciiFirst = 32, AsciiCount = 95;
+
+struct FontMetrics::Font {
+    stbtt_fontinfo info;
+
+    /* Vertical metrics relative to the font height, as computed by fontstash */
+    float ascender, descender, lineHeight;
+
+    /* Glyph indices and advances (in font units) of printable ASCII characters */
+    int asciiGlyph[AsciiCount], asciiAdvance[AsciiCount];
+
+    /* Kerning (in font units) between pairs of printable ASCII characters */
+    std::vector<int16_t> asciiKerning;
+
+    /* Lazily populated caches for all other characters */
+    mutable std::mutex mutex;
+    mutable std::unordered_map<uint32_t, std::pair<int, int>> glyphs;
+    mutable std::unordered_map<uint64_t, int> kerning;
+
+    void glyph(uint32_t codepoint, int &index, int &advance) const {
+        if (codepoint - AsciiFirst < AsciiCount) {
+            index = asciiGlyph[codepoint - AsciiFirst];
+            advance = asciiAdvance[codepoint - AsciiFirst];
+            return;
+        }
+        std::lock_guard<std::mutex> guard(mutex);
+        auto it = glyphs.find(codepoint);
+        if (it == glyphs.end()) {
+            int lsb, idx = stbtt_FindGlyphIndex(&info, (int) codepoint), adv = 0;
+            stbtt_GetGlyphHMetrics(&info, idx, &adv, &lsb);
+            it = glyphs.emplace(codepoint, std::make_pair(idx, adv)).first;
+        }
+        index = it->second.first;
+        advance = it->second.second;
+    }
+
+    int kern(uint32_t cp1, int glyph1, uint32_t cp2, int glyph2) const {
+        if (cp1 - AsciiFirst < AsciiCount && cp2 - AsciiFirst < AsciiCount)
+            return asciiKerning[(cp1 - AsciiFirst) * AsciiCount + (cp2 - AsciiFirst)];
+        uint64_t key = ((uint64_t) (uint32_t) glyph1 << 32) | (uint32_t) glyph2;
+        std::lock_guard<std::mutex> guard(mutex);
+        auto it = kerning.find(key);
+        if (it == kerning.end())
+            it = kerning.emplace(key, stbtt_GetGlyphKernAdvance(&info, glyph1, glyph2)).first;
+        return it->second;
+    }
+
+    /* Walks over the glyphs of a string and accumulates their advances
+       (with kerning) rounded to whole pixels, in the same way as fontstash */
+    struct Iterator {
+        const Font &font;
+        float scale;
+        const char *it, *end;
+        int prevGlyph;
+        uint32_t prevCodepoint;
+        /* Current code point and its horizontal extent */
+        uint32_t codepoint;
+        float x, nextX;
+
+        Iterator(const Font &font, float size, const char *begin, const char *end)
+            : font(font), scale(stbtt_ScaleForPixelHeight(&font.info, size)),
+              it(begin), end(end), prevGlyph(-1), prevCodepoint(0),
+              codepoint(0), x(0), nextX(0) { }
+
+        bool next() {
+            if (!nextCodepoint(it, end, codepoint))
+                return false;
+            int glyph, advance;
+            font.glyph(codepoint, glyph, advance);
+            x = nextX;
+            if (prevGlyph != -1)
+                x += (int) (font.kern(prevCodepoint, prevGlyph, codepoint, glyph) * scale + 0.5f);
+            nextX = x + (int) ((int16_t) (scale * advance * 10.f) / 10.f + 0.5f);
+            prevGlyph = glyph;
+            prevCodepoint = codepoint;
+            return true;
+        }
+    };
+};
+
+FontMetrics &FontMetrics::instance() {
+    /* Intentionally leaked, since widgets may be measured during shutdown */
+    static FontMetrics *instance = []() {
+        FontMetrics *metrics = new FontMetrics();
+        metrics->addFont("sans", roboto_regular_ttf, roboto_regular_ttf_size);
+        metrics->addFont("sans-bold", roboto_bold_ttf, roboto_bold_ttf_size);
+        metrics->addFont("icons", entypo_ttf, entypo_ttf_size);
+        return metrics;
+    }();
+    return *instance;
+}
+
+FontMetrics::FontMetrics() { }
+
+FontMetrics::~FontMetrics() { }
+
+void FontMetrics::addFont(const std::string &name, const uint8_t *data, size_t size) {
+    std::unique_ptr<Font> font(new Font());
+    if (size < 12 || !stbtt_InitFont(&font->info, data, 0))
+        throw std::runtime_error("FontMetrics::addFont(): could not parse font \"" + name + "\"!");
+
+    int ascent, descent, lineGap;
+    stbtt_GetFontVMetrics(&font->info, &ascent, &descent, &lineGap);
+    float height = (float) (ascent - descent);
+    font->ascender = ascent / height;
+    font->descender = descent / height;
+    font->lineHeight = (height + lineGap) / height;
+
+    for (uint32_t i = 0; i < AsciiCount; ++i) {
+        int lsb;
+        font->asciiGlyph[i] = stbtt_FindGlyphIndex(&font->info, (int) (AsciiFirst + i));
+        stbtt_GetGlyphHMetrics(&font->info, font->asciiGlyph[i], &font->asciiAdvance[i], &lsb);
+    }
+    font->asciiKerning.resize(AsciiCount * AsciiCount);
+    for (uint32_t i = 0; i < AsciiCount; ++i)
+        for (uint32_t j = 0; j < AsciiCount; ++j)
+            font->asciiKerning[i * AsciiCount + j] = (int16_t) stbtt_GetGlyphKernAdvance(
+                &font->info, font->asciiGlyph[i], font->asciiGlyph[j]);
+
+    std::lock_guard<std::mutex> guard(mMutex);
+    /* Fonts are never replaced, since other threads may be using them */
+    if (!mFonts.emplace(name, std::move(font)).second)
+        throw std::runtime_error("FontMetrics::addFont(): font \"" + name + "\" already exists!");
+}
+
+bool FontMetrics::hasFont(const std::string &name) const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return mFonts.find(name) != mFonts.end();
+}
+
+const FontMetrics::Font &FontMetrics::font(const std::string &name) const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    auto it = mFonts.find(name);
+    if (it == mFonts.end())
+        throw std::runtime_error("FontMetrics: unknown font \"" + name + "\"!");
+    return *it->second;
+}
+
+float FontMetrics::textWidth(const std::string &fontName, float size,
+                             const char *string, const char *end) const {
+    const Font &font = this->font(fontName);
+    if (!end)
+        end = string + strlen(string);
+
+    Font::Iterator iter(font, quantizeSize(size), string, end);
+    while (iter.next())
+        ;
+    return iter.nextX;
+}
+
+void FontMetrics::verticalMetrics(const std::string &fontName, float size, float *ascender,
+                                  float *descender, float *lineHeight) const {
+    const Font &font = this->font(fontName);
+    size = quantizeSize(size);
+    if (ascender)
+        *ascender = font.ascender * size;
+    if (descender)
+        *descender = font.descender * size;
+    if (lineHeight)
+        *lineHeight = font.lineHeight * size;
+}
+
+float FontMetrics::lineHeight(const std::string &font, float size) const {
+    float result;
+    verticalMetrics(font, size, nullptr, nullptr, &result);
+    return result;
+}
+
+void FontMetrics::layoutText(const std::string &fontName, float size, float breakWidth,
+                             const std::string &string, TextLayout &layout) const {
+    const Font &font = this->font(fontName);
+    const char *data = string.data();
+    Font::Iterator iter(font, quantizeSize(size), data, data + string.size());
+
+    layout.text = string;
+    layout.rows.clear();
+    layout.glyphs.clear();
+    layout.lineHeight = font.lineHeight * quantizeSize(size);
+
+    /* Position, byte offset and glyph index at a boundary within the string */
+    struct Mark { float x; uint32_t offset, glyph; };
+
+    bool inRow = false, inSpace = false;
+    /* Extent of the current row and word, and where the previous word ended */
+    Mark rowStart { 0, 0, 0 }, rowEnd = rowStart, wordStart = rowStart, prevWordEnd = rowStart;
+    uint32_t prevCodepoint = 0;
+
+    auto endRow = [&](const Mark &end) {
+        layout.rows.push_back(TextLayout::Row {
+            rowStart.offset, end.offset, rowStart.glyph, end.glyph, end.x - rowStart.x });
+        inRow = false;
+    };
+
+    while (true) {
+        const char *prev = iter.it;
+        if (!iter.next())
+            break;
+        uint32_t glyph = (uint32_t) layout.glyphs.size();
+        Mark before { iter.x, (uint32_t) (prev - data), glyph },
+             after { iter.nextX, (uint32_t) (iter.it - data), glyph + 1 };
+        layout.glyphs.push_back(TextLayout::Glyph { before.offset, iter.x, iter.nextX });
+        if (breakWidth <= 0)
+            continue;
+
+        uint32_t c = iter.codepoint;
+        if (c == '\n' || c == '\r') {
+            /* Treat "\r\n" as a single line break */
+            if (!(c == '\n' && prevCodepoint == '\r')) {
+                if (inRow) {
+                    endRow(rowEnd);
+                } else {
+                    rowStart = before;
+                    endRow(before);
+                }
+            }
+        } else if (c == ' ' || c == '\t' || c == 0x0b || c == 0x0c || c == 0x85 || c == 0xa0) {
+            inSpace = true;
+        } else if (!inRow) {
+            inRow = true;
+            inSpace = false;
+            rowStart = wordStart = before;
+            rowEnd = after;
+        } else {
+            if (inSpace) {
+                inSpace = false;
+                prevWordEnd = rowEnd;
+                wordStart = before;
+            }
+            if (after.x - rowStart.x > breakWidth) {
+                if (wordStart.glyph == rowStart.glyph) {
+                    /* The word fills the whole row: break it before this character */
+                    endRow(rowEnd);
+                    rowStart = wordStart = before;
+                } else {
+                    /* Move the current word to a new row */
+                    endRow(prevWordEnd);
+                    rowStart = wordStart;
+                }
+                inRow = true;
+            }
+            rowEnd = after;
+        }
+        prevCodepoint = c;
+    }
+
+    if (breakWidth <= 0) {
+        /* Single row spanning the whole string */
+        rowStart = Mark { 0, 0, 0 };
+        endRow(Mark { iter.nextX, (uint32_t) string.size(), (uint32_t) layout.glyphs.size() });
+    } else if (inRow) {
+        endRow(rowEnd);
+    }
+
+    /* Make glyph positions relative to the start of their row */
+    float maxWidth = 0;
+    for (const TextLayout::Row &row : layout.rows) {
+        maxWidth = std::max(maxWidth, row.width);
+        if (row.glyphBegin == row.glyphEnd)
+            continue;
+        float offset = layout.glyphs[row.glyphBegin].x;
+        for (uint32_t i = row.glyphBegin; i < row.glyphEnd; ++i) {
+            layout.glyphs[i].x -= offset;
+            layout.glyphs[i].nextX -= offset;
+        }
+    }
+    layout.size = Vector2f(maxWidth, layout.rows.size() * layout.lineHeight);
+}
+
+Vector2f FontMetrics::textBoxSize(const std::string &font, float size, float breakWidth,
+                                  const std::string &string) const {
+    TextLayout layout;
+    layoutText(font, size, breakWidth, string, layout);
+    return layout.size;
+}
+
+NAMESPACE_END(nanogui)
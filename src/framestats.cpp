@@ -0,0 +1,111 @@
+/*
+    src/framestats.cpp -- Ring buffer of per-frame timing statistics
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/framestats.h>
+#include <algorithm>
+#include <cmath>
+
+NAMESPACE_BEGIN(nanogui)
+
+FrameStats::FrameStats(size_t capacity)
+    : mCapacity(std::max(capacity, (size_t) 1)),
+      mData(new std::atomic<float>[mCapacity * PhaseCount]), mCount(0) {
+    for (size_t i = 0; i < mCapacity * PhaseCount; ++i)
+        mData[i].store(0.f, std::memory_order_relaxed);
+}
+
+void FrameStats::record(const Sample &sample) {
+    size_t count = mCount.load(std::memory_order_relaxed);
+    std::atomic<float> *slot = &mData[(count % mCapacity) * PhaseCount];
+    /* Pairs with the acquire fence in samples(): a reader that observes any
+       of the stores below also observes the counter of the previous call,
+       and therefore knows that this slot is being overwritten */
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < PhaseCount; ++i)
+        slot[i].store(sample[i], std::memory_order_relaxed);
+    /* Publish the sample only once all of its stores are visible */
+    std::atomic_thread_fence(std::memory_order_release);
+    mCount.store(count + 1, std::memory_order_relaxed);
+}
+
+void FrameStats::clear() {
+    mCount.store(0, std::memory_order_release);
+}
+
+std::vector<FrameStats::Sample> FrameStats::samples() const {
+    size_t end = mCount.load(std::memory_order_acquire);
+    size_t begin = end > mCapacity ? end - mCapacity : 0;
+
+    std::vector<Sample> result;
+    result.reserve(end - begin);
+    for (size_t index = begin; index < end; ++index) {
+        const std::atomic<float> *slot = &mData[(index % mCapacity) * PhaseCount];
+        Sample sample;
+        for (int i = 0; i < PhaseCount; ++i)
+            sample[i] = slot[i].load(std::memory_order_relaxed);
+        result.push_back(sample);
+    }
+
+    /* The writer may have overwritten (or be in the middle of overwriting)
+       the oldest slots while they were copied -- drop those samples. The
+       fence pairs with the ones in record(), so that the counter read below
+       accounts for every store that the loads above may have observed */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t endAfter = mCount.load(std::memory_order_relaxed);
+    if (endAfter + 1 > begin + mCapacity) {
+        size_t stale = std::min(endAfter + 1 - (begin + mCapacity), result.size());
+        result.erase(result.begin(), result.begin() + stale);
+    }
+
+    return result;
+}
+
+FrameStats::Summary FrameStats::summary(Phase phase) const {
+    std::vector<Sample> samples = this->samples();
+    Summary summary;
+    if (samples.empty())
+        return summary;
+
+    std::vector<float> values(samples.size());
+    double sum = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        values[i] = samples[i][phase];
+        sum += values[i];
+    }
+    std::sort(values.begin(), values.end());
+
+    /* Nearest-rank percentiles */
+    auto percentile = [&values](float p) {
+        size_t rank = (size_t) std::ceil(p * values.size());
+        return values[std::min(std::max(rank, (size_t) 1), values.size()) - 1];
+    };
+
+    summary.min = values.front();
+    summary.max = values.back();
+    summary.mean = (float) (sum / values.size());
+    summary.p95 = percentile(0.95f);
+    summary.p99 = percentile(0.99f);
+    return summary;
+}
+
+const char *FrameStats::phaseName(Phase phase) {
+    switch (phase) {
+        case Layout:   return "Layout";
+        case Contents: return "Contents";
+        case Draw:     return "Draw";
+        case Flush:    return "Flush";
+        case Swap:     return "Swap";
+        case Total:    return "Total";
+        default:       return "Unknown";
+    }
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,101 @@
+/*
+    src/framestatsoverlay.cpp -- Widget that displays the frame timings
+    of the enclosing screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/framestatsoverlay.h>
+#include <nanogui/screen.h>
+#include <nanogui/opengl.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+static const int rowHeight = 15;
+static const int plotHeight = 40;
+
+FrameStatsOverlay::FrameStatsOverlay(Widget *parent)
+    : Widget(parent), mTargetFrameTime(1000.f / 60.f) { }
+
+Vector2i FrameStatsOverlay::preferredSize(NVGcontext *) const {
+    return Vector2i(300, (FrameStats::PhaseCount + 1) * rowHeight + plotHeight + 12);
+}
+
+void FrameStatsOverlay::draw(NVGcontext *ctx) {
+    Widget::draw(ctx);
+
+    const Screen *screen = this->screen();
+    if (!screen)
+        return;
+
+    const FrameStats &stats = screen->frameStats();
+    std::vector<FrameStats::Sample> samples = stats.samples();
+
+    nvgBeginPath(ctx);
+    nvgRect(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+    nvgFillColor(ctx, Color(20, 200));
+    nvgFill(ctx);
+
+    nvgFontFace(ctx, "sans");
+    nvgFontSize(ctx, 14.0f);
+    nvgFillColor(ctx, Color(240, 192));
+
+    /* One row per phase: name, followed by right-aligned columns */
+    const char *header[] = { "ms", "min", "mean", "p95", "p99" };
+    auto drawRow = [&](int row, const char **cells) {
+        float y = mPos.y() + 4 + row * rowHeight;
+        nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+        nvgText(ctx, mPos.x() + 4, y, cells[0], nullptr);
+        nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
+        for (int i = 1; i < 5; ++i)
+            nvgText(ctx, mPos.x() + 70 + i * (mSize.x() - 74) / 4.f, y, cells[i], nullptr);
+    };
+    drawRow(0, header);
+
+    for (int i = 0; i < FrameStats::PhaseCount; ++i) {
+        FrameStats::Phase phase = (FrameStats::Phase) i;
+        FrameStats::Summary summary = stats.summary(phase);
+        float values[] = { summary.min, summary.mean, summary.p95, summary.p99 };
+        char buf[4][16];
+        const char *cells[5] = { FrameStats::phaseName(phase) };
+        for (int j = 0; j < 4; ++j) {
+            snprintf(buf[j], sizeof(buf[j]), "%.2f", values[j]);
+            cells[j + 1] = buf[j];
+        }
+        drawRow(i + 1, cells);
+    }
+
+    /* Plot the total frame time, scaled so that the target is at half height */
+    float px = mPos.x() + 4, py = mPos.y() + mSize.y() - 4 - plotHeight,
+          pw = mSize.x() - 8, scale = plotHeight / (2 * mTargetFrameTime);
+
+    if (samples.size() > 1) {
+        nvgBeginPath(ctx);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            float value = std::min(samples[i][FrameStats::Total] * scale, (float) plotHeight);
+            float vx = px + i * pw / (float) (stats.capacity() - 1);
+            float vy = py + plotHeight - value;
+            if (i == 0)
+                nvgMoveTo(ctx, vx, vy);
+            else
+                nvgLineTo(ctx, vx, vy);
+        }
+        nvgStrokeColor(ctx, Color(255, 192, 0, 255));
+        nvgStroke(ctx);
+    }
+
+    nvgBeginPath(ctx);
+    nvgMoveTo(ctx, px, py + plotHeight / 2);
+    nvgLineTo(ctx, px + pw, py + plotHeight / 2);
+    nvgStrokeColor(ctx, Color(255, 0, 0, 128));
+    nvgStroke(ctx);
+
+    invalidate();
+}
+
+NAMESPACE_END(nanogui)
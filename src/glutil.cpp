@@ -363,7 +363,8 @@ void GLFramebuffer::init(const Vector2i &size, int nSamples) {
 void GLFramebuffer::free() {
     glDeleteRenderbuffers(1, &mColor);
     glDeleteRenderbuffers(1, &mDepth);
-    mColor = mDepth = 0;
+    glDeleteFramebuffers(1, &mFramebuffer);
+    mFramebuffer = mColor = mDepth = 0;
 }
 
 void GLFramebuffer::bind() {
@@ -378,13 +379,14 @@ void GLFramebuffer::release() {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void GLFramebuffer::blit() {
+void GLFramebuffer::blit(bool depth) {
     glBindFramebuffer(GL_READ_FRAMEBUFFER, mFramebuffer);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     glDrawBuffer(GL_BACK);
 
     glBlitFramebuffer(0, 0, mSize.x(), mSize.y(), 0, 0, mSize.x(), mSize.y(),
-                      GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+                      GL_COLOR_BUFFER_BIT | (depth ? GL_DEPTH_BUFFER_BIT : 0),
+                      GL_NEAREST);
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
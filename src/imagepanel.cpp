@@ -41,7 +41,11 @@ int ImagePanel::indexForPosition(const Vector2i &p) const {
 
 bool ImagePanel::mouseMotionEvent(const Vector2i &p, const Vector2i & /* rel */,
                               int /* button */, int /* modifiers */) {
-    mMouseIndex = indexForPosition(p);
+    int index = indexForPosition(p);
+    if (index != mMouseIndex) {
+        mMouseIndex = index;
+        invalidate();
+    }
     return true;
 }
 
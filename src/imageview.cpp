@@ -115,10 +115,12 @@ void ImageView::setImageCoordinateAt(const Vector2f& position, const Vector2f& i
     mOffset = mOffset.array().
         min(sizeF().array()).
         max(-scaledImageSizeF().array());
+    invalidate();
 }
 
 void ImageView::center() {
     mOffset = (sizeF() - scaledImageSizeF()) / 2;
+    invalidate();
 }
 
 void ImageView::fit() {
@@ -288,7 +290,7 @@ void ImageView::draw(NVGcontext* ctx) {
 
     // Calculate several variables that need to be send to OpenGL in order for the image to be
     // properly displayed inside the widget.
-    const Screen* screen = dynamic_cast<const Screen*>(this->window()->parent());
+    const Screen* screen = this->screen();
     assert(screen);
     Vector2f screenSize = screen->size().cast<float>();
     Vector2f scaleFactor = mScale * imageSizeF().cwiseQuotient(screenSize);
@@ -320,6 +322,7 @@ void ImageView::updateImageParameters() {
     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
     mImageSize = Vector2i(w, h);
+    invalidatePreferredSize();
 }
 
 void ImageView::drawWidgetBorder(NVGcontext* ctx) const {
@@ -337,7 +340,7 @@ void ImageView::drawWidgetBorder(NVGcontext* ctx) const {
 void ImageView::drawImageBorder(NVGcontext* ctx) const {
     nvgSave(ctx);
     nvgBeginPath(ctx);
-    nvgScissor(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+    nvgIntersectScissor(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
     nvgStrokeWidth(ctx, 1.0f);
     Vector2i borderPosition = mPos + mOffset.cast<int>();
     Vector2i borderSize = scaledImageSizeF().cast<int>();
@@ -359,7 +362,7 @@ void ImageView::drawHelpers(NVGcontext* ctx) const {
     Vector2f sizeOffsetDifference = sizeF() - mOffset;
     Vector2f scissorSize = sizeOffsetDifference.array().min(sizeF().array());
     nvgSave(ctx);
-    nvgScissor(ctx, scissorPosition.x(), scissorPosition.y(), scissorSize.x(), scissorSize.y());
+    nvgIntersectScissor(ctx, scissorPosition.x(), scissorPosition.y(), scissorSize.x(), scissorSize.y());
     if (gridVisible())
         drawPixelGrid(ctx, upperLeftCorner, lowerRightCorner, mScale);
     if (pixelInfoVisible())
@@ -12,12 +12,15 @@
 #include <nanogui/label.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/fontmetrics.h>
+#include <nanogui/textlayout.h>
 #include <nanogui/serializer/core.h>
 
 NAMESPACE_BEGIN(nanogui)
 
 Label::Label(Widget *parent, const std::string &caption, const std::string &font, int fontSize)
     : Widget(parent), mCaption(caption), mFont(font) {
+    mTypeTags |= TypeLabel;
     if (mTheme) {
         mFontSize = mTheme->mStandardFontSize;
         mColor = mTheme->mTextColor;
@@ -36,6 +39,20 @@ void Label::setTheme(Theme *theme) {
 Vector2i Label::preferredSize(NVGcontext *ctx) const {
     if (mCaption == "")
         return Vector2i::Zero();
+
+    if (FontMetrics::instance().hasFont(mFont)) {
+        auto layout = TextLayoutCache::instance().layout(
+            mFont, fontSize(), mCaption, mFixedSize.x());
+        if (mFixedSize.x() > 0)
+            return Vector2i(mFixedSize.x(), (int) layout->size.y());
+        else
+            return Vector2i((int) layout->size.x(), mTheme->mStandardFontSize);
+    }
+
+    /* Fonts registered with NanoVG by the application are measured using the context */
+    if (!ctx)
+        throw std::runtime_error("Label::preferredSize(): font \"" + mFont +
+                                 "\" can only be measured using a NanoVG context!");
     nvgFontFace(ctx, mFont.c_str());
     nvgFontSize(ctx, fontSize());
     if (mFixedSize.x() > 0) {
@@ -80,6 +97,7 @@ bool Label::load(Serializer &s) {
     if (!s.get("caption", mCaption)) return false;
     if (!s.get("font", mFont)) return false;
     if (!s.get("color", mColor)) return false;
+    invalidatePreferredSize();
     return true;
 }
 
@@ -16,6 +16,7 @@
 #include <nanogui/window.h>
 #include <nanogui/theme.h>
 #include <nanogui/label.h>
+#include <nanogui/profiler.h>
 #include <numeric>
 
 NAMESPACE_BEGIN(nanogui)
@@ -30,7 +31,7 @@ Vector2i BoxLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const {
     Vector2i size = Vector2i::Constant(2*mMargin);
 
     int yOffset = 0;
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty()) {
         if (mOrientation == Orientation::Vertical)
             size[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
@@ -41,14 +42,14 @@ Vector2i BoxLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const {
     bool first = true;
     int axis1 = (int) mOrientation, axis2 = ((int) mOrientation + 1)%2;
     for (auto w : widget->children()) {
-        if (!w->visible())
+        if (!w->inLayout())
             continue;
         if (first)
             first = false;
         else
             size[axis1] += mSpacing;
 
-        Vector2i ps = w->preferredSize(ctx), fs = w->fixedSize();
+        Vector2i ps = w->cachedPreferredSize(ctx), fs = w->fixedSize();
         Vector2i targetSize(
             fs[0] ? fs[0] : ps[0],
             fs[1] ? fs[1] : ps[1]
@@ -72,7 +73,7 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     int position = mMargin;
     int yOffset = 0;
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty()) {
         if (mOrientation == Orientation::Vertical) {
             position += widget->theme()->mWindowHeaderHeight - mMargin/2;
@@ -84,14 +85,14 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
     bool first = true;
     for (auto w : widget->children()) {
-        if (!w->visible())
+        if (!w->inLayout())
             continue;
         if (first)
             first = false;
         else
             position += mSpacing;
 
-        Vector2i ps = w->preferredSize(ctx), fs = w->fixedSize();
+        Vector2i ps = w->cachedPreferredSize(ctx), fs = w->fixedSize();
         Vector2i targetSize(
             fs[0] ? fs[0] : ps[0],
             fs[1] ? fs[1] : ps[1]
@@ -118,7 +119,7 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
         w->setPosition(pos);
         w->setSize(targetSize);
-        w->performLayout(ctx);
+        Profiler::performLayout(w, ctx);
         position += targetSize[axis1];
     }
 }
@@ -126,20 +127,20 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 Vector2i GroupLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const {
     int height = mMargin, width = 2*mMargin;
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty())
         height += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
     bool first = true, indent = false;
     for (auto c : widget->children()) {
-        if (!c->visible())
+        if (!c->inLayout())
             continue;
-        const Label *label = dynamic_cast<const Label *>(c);
+        const Label *label = widget_cast<const Label>(c);
         if (!first)
             height += (label == nullptr) ? mSpacing : mGroupSpacing;
         first = false;
 
-        Vector2i ps = c->preferredSize(ctx), fs = c->fixedSize();
+        Vector2i ps = c->cachedPreferredSize(ctx), fs = c->fixedSize();
         Vector2i targetSize(
             fs[0] ? fs[0] : ps[0],
             fs[1] ? fs[1] : ps[1]
@@ -160,22 +161,22 @@ void GroupLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     int height = mMargin, availableWidth =
         (widget->fixedWidth() ? widget->fixedWidth() : widget->width()) - 2*mMargin;
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty())
         height += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
     bool first = true, indent = false;
     for (auto c : widget->children()) {
-        if (!c->visible())
+        if (!c->inLayout())
             continue;
-        const Label *label = dynamic_cast<const Label *>(c);
+        const Label *label = widget_cast<const Label>(c);
         if (!first)
             height += (label == nullptr) ? mSpacing : mGroupSpacing;
         first = false;
 
         bool indentCur = indent && label == nullptr;
         Vector2i ps = Vector2i(availableWidth - (indentCur ? mGroupIndent : 0),
-                               c->preferredSize(ctx).y());
+                               c->cachedPreferredSize(ctx).y());
         Vector2i fs = c->fixedSize();
 
         Vector2i targetSize(
@@ -185,7 +186,7 @@ void GroupLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
         c->setPosition(Vector2i(mMargin + (indentCur ? mGroupIndent : 0), height));
         c->setSize(targetSize);
-        c->performLayout(ctx);
+        Profiler::performLayout(c, ctx);
 
         height += targetSize.y();
 
@@ -207,7 +208,7 @@ Vector2i GridLayout::preferredSize(NVGcontext *ctx,
          + std::max((int) grid[1].size() - 1, 0) * mSpacing[1]
     );
 
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty())
         size[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
@@ -218,7 +219,7 @@ void GridLayout::computeLayout(NVGcontext *ctx, const Widget *widget, std::vecto
     int axis1 = (int) mOrientation, axis2 = (axis1 + 1) % 2;
     size_t numChildren = widget->children().size(), visibleChildren = 0;
     for (auto w : widget->children())
-        visibleChildren += w->visible() ? 1 : 0;
+        visibleChildren += w->inLayout() ? 1 : 0;
 
     Vector2i dim;
     dim[axis1] = mResolution;
@@ -235,9 +236,9 @@ void GridLayout::computeLayout(NVGcontext *ctx, const Widget *widget, std::vecto
                 if (child >= numChildren)
                     return;
                 w = widget->children()[child++];
-            } while (!w->visible());
+            } while (!w->inLayout());
 
-            Vector2i ps = w->preferredSize(ctx);
+            Vector2i ps = w->cachedPreferredSize(ctx);
             Vector2i fs = w->fixedSize();
             Vector2i targetSize(
                 fs[0] ? fs[0] : ps[0],
@@ -263,7 +264,7 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     int dim[2] = { (int) grid[0].size(), (int) grid[1].size() };
 
     Vector2i extra = Vector2i::Zero();
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty())
         extra[1] += widget->theme()->mWindowHeaderHeight - mMargin / 2;
 
@@ -303,9 +304,9 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
                 if (child >= numChildren)
                     return;
                 w = widget->children()[child++];
-            } while (!w->visible());
+            } while (!w->inLayout());
 
-            Vector2i ps = w->preferredSize(ctx);
+            Vector2i ps = w->cachedPreferredSize(ctx);
             Vector2i fs = w->fixedSize();
             Vector2i targetSize(
                 fs[0] ? fs[0] : ps[0],
@@ -334,7 +335,7 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
             }
             w->setPosition(itemPos);
             w->setSize(targetSize);
-            w->performLayout(ctx);
+            Profiler::performLayout(w, ctx);
             pos[axis1] += grid[axis1][i1] + mSpacing[axis1];
         }
         pos[axis2] += grid[axis2][i2] + mSpacing[axis2];
@@ -357,7 +358,7 @@ Vector2i AdvancedGridLayout::preferredSize(NVGcontext *ctx, const Widget *widget
         std::accumulate(grid[1].begin(), grid[1].end(), 0));
 
     Vector2i extra = Vector2i::Constant(2 * mMargin);
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty())
         extra[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
@@ -369,7 +370,7 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
     computeLayout(ctx, widget, grid);
 
     grid[0].insert(grid[0].begin(), mMargin);
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty())
         grid[1].insert(grid[1].begin(), widget->theme()->mWindowHeaderHeight + mMargin/2);
     else
@@ -380,13 +381,13 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
             grid[axis][i] += grid[axis][i-1];
 
         for (Widget *w : widget->children()) {
-            if (!w->visible())
+            if (!w->inLayout())
                 continue;
             Anchor anchor = this->anchor(w);
 
             int itemPos = grid[axis][anchor.pos[axis]];
             int cellSize  = grid[axis][anchor.pos[axis] + anchor.size[axis]] - itemPos;
-            int ps = w->preferredSize(ctx)[axis], fs = w->fixedSize()[axis];
+            int ps = w->cachedPreferredSize(ctx)[axis], fs = w->fixedSize()[axis];
             int targetSize = fs ? fs : ps;
 
             switch (anchor.align[axis]) {
@@ -408,7 +409,7 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
             size[axis] = targetSize;
             w->setPosition(pos);
             w->setSize(size);
-            w->performLayout(ctx);
+            Profiler::performLayout(w, ctx);
         }
     }
 }
@@ -422,7 +423,7 @@ void AdvancedGridLayout::computeLayout(NVGcontext *ctx, const Widget *widget,
     );
 
     Vector2i extra = Vector2i::Constant(2 * mMargin);
-    const Window *window = dynamic_cast<const Window *>(widget);
+    const Window *window = widget_cast<const Window>(widget);
     if (window && !window->title().empty())
         extra[1] += widget->theme()->mWindowHeaderHeight - mMargin/2;
 
@@ -437,12 +438,12 @@ void AdvancedGridLayout::computeLayout(NVGcontext *ctx, const Widget *widget,
         for (int phase = 0; phase < 2; ++phase) {
             for (auto pair : mAnchor) {
                 const Widget *w = pair.first;
-                if (!w->visible())
+                if (!w->inLayout())
                     continue;
                 const Anchor &anchor = pair.second;
                 if ((anchor.size[axis] == 1) != (phase == 0))
                     continue;
-                int ps = w->preferredSize(ctx)[axis], fs = w->fixedSize()[axis];
+                int ps = w->cachedPreferredSize(ctx)[axis], fs = w->fixedSize()[axis];
                 int targetSize = fs ? fs : ps;
 
                 if (anchor.pos[axis] + anchor.size[axis] > (int) grid.size())
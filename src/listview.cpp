@@ -0,0 +1,277 @@
+/*
+    src/listview.cpp -- Scrollable list that only instantiates widgets
+    for the rows that are currently visible
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/listview.h>
+#include <nanogui/screen.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/profiler.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <cmath>
+
+NAMESPACE_BEGIN(nanogui)
+
+ListView::ListView(Widget *parent)
+    : Widget(parent), mRowHeight(25), mRowCount(0), mScroll(0), mFirstRow(0),
+      mReload(true) { }
+
+void ListView::reload() {
+    mReload = true;
+    refreshRows();
+}
+
+void ListView::reloadRow(int index) {
+    Widget *row = rowWidget(index);
+    if (!row)
+        return;
+    /* Hand the widget back to the pool, from which updateRows() takes it
+       again. Hide it in the meantime, so that it doesn't receive events */
+    mRows[index - mFirstRow] = nullptr;
+    row->setVisible(false);
+    mSpareRows.push_back(row);
+    refreshRows();
+}
+
+Widget *ListView::rowWidget(int index) {
+    if (mReload || index < mFirstRow || index >= mFirstRow + (int) mRows.size())
+        return nullptr;
+    return mRows[index - mFirstRow];
+}
+
+void ListView::setScrollOffset(int offset) {
+    /* The upper bound is enforced by updateRows(), once the row count is known */
+    offset = std::max(offset, 0);
+    if (offset == mScroll)
+        return;
+    mScroll = offset;
+    refreshRows();
+}
+
+void ListView::scrollToRow(int index) {
+    if (index < 0 || index >= mRowCount)
+        return;
+    int top = rowTop(index), bottom = top + rowHeightAt(index);
+    if (top < mScroll)
+        setScrollOffset(top);
+    else if (bottom > mScroll + mSize.y())
+        setScrollOffset(bottom - mSize.y());
+}
+
+int ListView::contentHeight() const {
+    if (mRowHeightCallback)
+        return mRowOffsets.empty() ? 0 : mRowOffsets.back();
+    return mRowCount * mRowHeight;
+}
+
+int ListView::rowTop(int index) const {
+    return mRowHeightCallback ? mRowOffsets[index] : index * mRowHeight;
+}
+
+int ListView::rowHeightAt(int index) const {
+    return mRowHeightCallback ? mRowOffsets[index + 1] - mRowOffsets[index] : mRowHeight;
+}
+
+int ListView::rowAt(int y) const {
+    if (mRowHeightCallback)
+        return (int) (std::upper_bound(mRowOffsets.begin(), mRowOffsets.end(), y) -
+                      mRowOffsets.begin()) - 1;
+    return y / std::max(mRowHeight, 1);
+}
+
+float ListView::scrollbarHeight() const {
+    /* Keep the thumb large enough to be grabbed, even for very long lists */
+    return std::max(height() * std::min(1.0f, height() / (float) contentHeight()),
+                    std::min(20.0f, height() - 8.0f));
+}
+
+void ListView::updateRows(NVGcontext *ctx) {
+    if (mReload) {
+        mRowCount = mRowCountCallback ? std::max(mRowCountCallback(), 0) : 0;
+        mRowOffsets.clear();
+        if (mRowHeightCallback) {
+            mRowOffsets.resize(mRowCount + 1);
+            mRowOffsets[0] = 0;
+            for (int i = 0; i < mRowCount; ++i)
+                mRowOffsets[i + 1] = mRowOffsets[i] + std::max(mRowHeightCallback(i), 0);
+        }
+
+        /* Every visible row must be bound anew */
+        for (auto row : mRows)
+            if (row)
+                mSpareRows.push_back(row);
+        mRows.clear();
+    }
+
+    int contentHeight = this->contentHeight();
+    mScroll = std::max(0, std::min(mScroll, contentHeight - mSize.y()));
+
+    int first = 0, last = 0;
+    if (mRowCount > 0 && mSize.y() > 0) {
+        first = std::min(rowAt(mScroll), mRowCount - 1);
+        last = std::min(rowAt(mScroll + mSize.y() - 1), mRowCount - 1) + 1;
+    }
+
+    /* Keep the widgets of rows that remain visible and recycle the others */
+    std::vector<Widget *> rows(last - first, nullptr);
+    for (size_t i = 0; i < mRows.size(); ++i) {
+        Widget *row = mRows[i];
+        int index = mFirstRow + (int) i;
+        if (!row)
+            continue;
+        if (index >= first && index < last)
+            rows[index - first] = row;
+        else
+            mSpareRows.push_back(row);
+    }
+    mRows.swap(rows);
+    mFirstRow = first;
+
+    int width = mSize.x() - (contentHeight > mSize.y() ? 12 : 0);
+    for (size_t i = 0; i < mRows.size(); ++i) {
+        int index = first + (int) i;
+        Widget *row = mRows[i];
+        bool bound = false;
+
+        if (!row) {
+            if (!mSpareRows.empty()) {
+                row = mSpareRows.back();
+                mSpareRows.pop_back();
+            } else {
+                if (!mRowFactory)
+                    throw std::runtime_error("ListView: no row factory was specified!");
+                row = mRowFactory(this);
+                if (!row || row->parent() != this)
+                    throw std::runtime_error("ListView: the row factory must create a "
+                                             "child of the list view!");
+            }
+            mRows[i] = row;
+            row->setVisible(true);
+            if (mBindCallback)
+                mBindCallback(row, index);
+            bound = true;
+        }
+
+        Vector2i size(width, rowHeightAt(index));
+        bool resized = row->size() != size;
+        row->setPosition(Vector2i(0, rowTop(index) - mScroll));
+        row->setSize(size);
+        if (bound || resized)
+            Profiler::performLayout(row, ctx);
+    }
+
+    for (auto row : mSpareRows)
+        row->setVisible(false);
+
+    mReload = false;
+}
+
+void ListView::refreshRows() {
+    /* Update the rows right away rather than while drawing, which must not
+       modify the widget tree. Without a screen (i.e. NanoVG context) or row
+       factory, the list is still being set up and the next layout pass takes
+       care of it */
+    Screen *screen = this->screen();
+    if (screen && mRowFactory)
+        updateRows(screen->nvgContext());
+    else
+        invalidateLayout();
+    invalidate();
+}
+
+void ListView::performLayout(NVGcontext *ctx) {
+    updateRows(ctx);
+}
+
+Vector2i ListView::preferredSize(NVGcontext *) const {
+    return Vector2i(200, 10 * mRowHeight);
+}
+
+bool ListView::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
+                              int button, int modifiers) {
+    int contentHeight = this->contentHeight();
+    /* Range of motion of the scrollbar thumb, which vanishes for very short lists */
+    float track = mSize.y() - 8 - scrollbarHeight();
+    if (contentHeight > mSize.y() && track > 0) {
+        setScrollOffset(mScroll + (int) std::round(
+            rel.y() * (contentHeight - mSize.y()) / track));
+        return true;
+    } else {
+        return Widget::mouseDragEvent(p, rel, button, modifiers);
+    }
+}
+
+bool ListView::scrollEvent(const Vector2i &p, const Vector2f &rel) {
+    if (contentHeight() > mSize.y()) {
+        setScrollOffset(mScroll - (int) std::round(rel.y() * mRowHeight * 3));
+        return true;
+    } else {
+        return Widget::scrollEvent(p, rel);
+    }
+}
+
+void ListView::draw(NVGcontext *ctx) {
+    nvgSave(ctx);
+    nvgTranslate(ctx, mPos.x(), mPos.y());
+    {
+        ClipScope clip(ctx, Vector2f::Zero(), mSize.cast<float>());
+        /* Rows handed back by reloadRow() are null until updateRows() runs */
+        for (auto row : mRows)
+            if (row)
+                Profiler::draw(row, ctx);
+    }
+    nvgRestore(ctx);
+
+    int contentHeight = this->contentHeight();
+    if (contentHeight <= mSize.y())
+        return;
+
+    float scrollh = scrollbarHeight();
+    float scroll = mScroll / (float) (contentHeight - mSize.y());
+
+    NVGpaint paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 + 1, mPos.y() + 4 + 1, 8,
+        mSize.y() - 8, 3, 4, Color(0, 32), Color(0, 92));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12, mPos.y() + 4, 8,
+                   mSize.y() - 8, 3);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+
+    paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 - 1,
+        mPos.y() + 4 + (mSize.y() - 8 - scrollh) * scroll - 1, 8, scrollh,
+        3, 4, Color(220, 100), Color(128, 100));
+
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12 + 1,
+                   mPos.y() + 4 + 1 + (mSize.y() - 8 - scrollh) * scroll, 8 - 2,
+                   scrollh - 2, 2);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+}
+
+void ListView::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("rowHeight", mRowHeight);
+    s.set("scroll", mScroll);
+}
+
+bool ListView::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    if (!s.get("rowHeight", mRowHeight)) return false;
+    if (!s.get("scroll", mScroll)) return false;
+    reload();
+    return true;
+}
+
+NAMESPACE_END(nanogui)
@@ -14,12 +14,25 @@
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 #include <nanogui/serializer/core.h>
+#include <algorithm>
 
 NAMESPACE_BEGIN(nanogui)
 
 Popup::Popup(Widget *parent, Window *parentWindow)
     : Window(parent, ""), mParentWindow(parentWindow),
       mAnchorPos(Vector2i::Zero()), mAnchorHeight(30) {
+    mTypeTags |= TypePopup;
+    if (mParentWindow) {
+        mParentWindow->mPopups.push_back(this);
+        mWidgetPool = mParentWindow->mWidgetPool;
+    }
+}
+
+Popup::~Popup() {
+    if (!mParentWindow)
+        return;
+    auto &popups = mParentWindow->mPopups;
+    popups.erase(std::remove(popups.begin(), popups.end(), this), popups.end());
 }
 
 void Popup::performLayout(NVGcontext *ctx) {
@@ -33,14 +46,15 @@ void Popup::performLayout(NVGcontext *ctx) {
 }
 
 void Popup::refreshRelativePlacement() {
-    mParentWindow->refreshRelativePlacement();
-    mVisible &= mParentWindow->visibleRecursive();
-    mPos = mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight);
+    if (!mParentWindow)
+        return;
+    setVisible(mVisible && mParentWindow->visibleRecursive());
+    setPosition(mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight));
+    /* Nested popups follow this one */
+    Window::refreshRelativePlacement();
 }
 
 void Popup::draw(NVGcontext* ctx) {
-    refreshRelativePlacement();
-
     if (!mVisible)
         return;
 
@@ -0,0 +1,117 @@
+/*
+    src/profiler.cpp -- Opt-in profiler that records the time spent in
+    the draw and layout methods of individual widgets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/profiler.h>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__GNUG__)
+#  include <cxxabi.h>
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+struct ProfilerEvent {
+    const std::type_info *type;
+    std::string id;
+    const char *category;
+    double start, duration; /* in microseconds */
+};
+
+static std::vector<ProfilerEvent> events;
+static std::chrono::steady_clock::time_point origin;
+
+static std::string typeName(const std::type_info &type) {
+    std::string name = type.name();
+#if defined(__GNUG__)
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (status == 0 && demangled)
+        name = demangled;
+    free(demangled);
+#endif
+    for (const std::string prefix : { "class ", "nanogui::" })
+        if (name.compare(0, prefix.size(), prefix) == 0)
+            name = name.substr(prefix.size());
+    return name;
+}
+
+static std::string escapeJSON(const std::string &str) {
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    result += buf;
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+bool Profiler::sActive = false;
+
+void Profiler::start() {
+    events.clear();
+    origin = std::chrono::steady_clock::now();
+    sActive = true;
+}
+
+void Profiler::stop() {
+    sActive = false;
+}
+
+size_t Profiler::eventCount() {
+    return events.size();
+}
+
+void Profiler::record(const Widget *widget, const char *category,
+                      std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    using us = std::chrono::duration<double, std::micro>;
+    events.push_back(ProfilerEvent{ &typeid(*widget), widget->id(), category,
+                                    us(start - origin).count(), us(end - start).count() });
+}
+
+void Profiler::saveTrace(const std::string &filename) {
+    std::ofstream os(filename);
+    if (!os)
+        throw std::runtime_error("Profiler::saveTrace(): could not open \"" +
+                                 filename + "\"!");
+
+    os << "{\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const ProfilerEvent &e = events[i];
+        std::string name = typeName(*e.type);
+        if (!e.id.empty())
+            name += " (" + e.id + ")";
+        char times[64];
+        snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f", e.start, e.duration);
+        os << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << escapeJSON(name)
+           << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\"," << times
+           << ",\"pid\":0,\"tid\":0}";
+    }
+    os << "\n]}\n";
+}
+
+NAMESPACE_END(nanogui)
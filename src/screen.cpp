@@ -16,8 +16,15 @@
 #include <nanogui/opengl.h>
 #include <nanogui/window.h>
 #include <nanogui/popup.h>
+#include <nanogui/profiler.h>
+#include <nanogui/eventlog.h>
+#include <nanogui/threadpool.h>
+#include <nanogui/textlayout.h>
+#include <cmath>
 #include <map>
 #include <iostream>
+#include <limits>
+#include <unordered_map>
 
 #if defined(_WIN32)
 #  define NOMINMAX
@@ -34,6 +41,7 @@
 /* Allow enforcing the GL2 implementation of NanoVG */
 #define NANOVG_GL3_IMPLEMENTATION
 #include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -92,17 +100,31 @@ static float get_pixel_ratio(GLFWwindow *window) {
 Screen::Screen()
     : Widget(nullptr), mGLFWWindow(nullptr), mNVGContext(nullptr),
       mCursor(Cursor::Arrow), mBackground(0.3f, 0.3f, 0.32f, 1.f),
-      mShutdownGLFWOnDestruct(false), mFullscreen(false) {
+      mShutdownGLFWOnDestruct(false), mFullscreen(false), mHeadless(false),
+      mRedraw(true),
+      mPartialRedraw(false), mDamageMin(Vector2i::Zero()),
+      mDamageMax(Vector2i::Zero()), mLayoutTime(0), mDrawTime(0), mFlushTime(0),
+      mCoalesceMotion(false), mMotionPending(false), mAutoLayout(false),
+      mTooltipDeadline(std::numeric_limits<double>::infinity()),
+      mTaskBudget(0.005) {
+    mTypeTags |= TypeScreen;
     memset(mCursors, 0, sizeof(GLFWcursor *) * (int) Cursor::CursorCount);
 }
 
 Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
                bool fullscreen, int colorBits, int alphaBits, int depthBits,
                int stencilBits, int nSamples,
-               unsigned int glMajor, unsigned int glMinor)
+               unsigned int glMajor, unsigned int glMinor, bool headless)
     : Widget(nullptr), mGLFWWindow(nullptr), mNVGContext(nullptr),
       mCursor(Cursor::Arrow), mBackground(0.3f, 0.3f, 0.32f, 1.f), mCaption(caption),
-      mShutdownGLFWOnDestruct(false), mFullscreen(fullscreen) {
+      mShutdownGLFWOnDestruct(false), mFullscreen(fullscreen && !headless),
+      mHeadless(headless), mRedraw(true),
+      mPartialRedraw(false), mDamageMin(Vector2i::Zero()),
+      mDamageMax(Vector2i::Zero()), mLayoutTime(0), mDrawTime(0), mFlushTime(0),
+      mCoalesceMotion(false), mMotionPending(false), mAutoLayout(false),
+      mTooltipDeadline(std::numeric_limits<double>::infinity()),
+      mTaskBudget(0.005) {
+    mTypeTags |= TypeScreen;
     memset(mCursors, 0, sizeof(GLFWcursor *) * (int) Cursor::CursorCount);
 
     /* Request a forward compatible OpenGL glMajor.glMinor core profile context.
@@ -112,7 +134,9 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    glfwWindowHint(GLFW_SAMPLES, nSamples);
+    /* Headless screens render into a single-sampled offscreen buffer, so
+       NanoVG must perform its own antialiasing */
+    glfwWindowHint(GLFW_SAMPLES, headless ? 0 : nSamples);
     glfwWindowHint(GLFW_RED_BITS, colorBits);
     glfwWindowHint(GLFW_GREEN_BITS, colorBits);
     glfwWindowHint(GLFW_BLUE_BITS, colorBits);
@@ -122,7 +146,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
     glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
     glfwWindowHint(GLFW_RESIZABLE, resizable ? GL_TRUE : GL_FALSE);
 
-    if (fullscreen) {
+    if (mFullscreen) {
         GLFWmonitor *monitor = glfwGetPrimaryMonitor();
         const GLFWvidmode *mode = glfwGetVideoMode(monitor);
         mGLFWWindow = glfwCreateWindow(mode->width, mode->height,
@@ -255,6 +279,17 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
         }
     );
 
+    /* The window contents were damaged (e.g. by an overlapping window) and
+       need to be redrawn even though no widget has changed */
+    glfwSetWindowRefreshCallback(mGLFWWindow,
+        [](GLFWwindow *w) {
+            auto it = __nanogui_screens.find(w);
+            if (it == __nanogui_screens.end())
+                return;
+            it->second->invalidate(true);
+        }
+    );
+
     initialize(mGLFWWindow, true);
 }
 
@@ -264,7 +299,7 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
     glfwGetWindowSize(mGLFWWindow, &mSize[0], &mSize[1]);
     glfwGetFramebufferSize(mGLFWWindow, &mFBSize[0], &mFBSize[1]);
 
-    mPixelRatio = get_pixel_ratio(window);
+    mPixelRatio = mHeadless ? 1.f : get_pixel_ratio(window);
 
 #if defined(_WIN32) || defined(__linux__)
     if (mPixelRatio != 1 && !mFullscreen)
@@ -299,12 +334,12 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
     if (mNVGContext == nullptr)
         throw std::runtime_error("Could not initialize NanoVG!");
 
-    mVisible = glfwGetWindowAttrib(window, GLFW_VISIBLE) != 0;
+    mVisible = mHeadless || glfwGetWindowAttrib(window, GLFW_VISIBLE) != 0;
     setTheme(new Theme(mNVGContext));
     mMousePos = Vector2i::Zero();
     mMouseState = mModifiers = 0;
     mDragActive = false;
-    mLastInteraction = glfwGetTime();
+    mLastInteraction = time();
     mProcessEvents = true;
     __nanogui_screens[mGLFWWindow] = this;
 
@@ -313,11 +348,19 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
 }
 
 Screen::~Screen() {
+    /* Release the widgets while the task queue and NanoVG context still
+       exist, since their destructors may wait for threads that use them */
+    for (auto child : mChildren)
+        child->decRef();
+    mChildren.clear();
+
     __nanogui_screens.erase(mGLFWWindow);
     for (int i=0; i < (int) Cursor::CursorCount; ++i) {
         if (mCursors[i])
             glfwDestroyCursor(mCursors[i]);
     }
+    if (mBackBuffer.ready())
+        mBackBuffer.free();
     if (mNVGContext)
         nvgDeleteGL3(mNVGContext);
     if (mGLFWWindow && mShutdownGLFWOnDestruct)
@@ -327,7 +370,10 @@ Screen::~Screen() {
 void Screen::setVisible(bool visible) {
     if (mVisible != visible) {
         mVisible = visible;
+        invalidate(true);
 
+        if (mHeadless)
+            return;
         if (visible)
             glfwShowWindow(mGLFWWindow);
         else
@@ -352,16 +398,299 @@ void Screen::setSize(const Vector2i &size) {
 #endif
 }
 
+void Screen::setPartialRedraw(bool partialRedraw) {
+    if (mPartialRedraw == partialRedraw)
+        return;
+    mPartialRedraw = partialRedraw;
+    if (!partialRedraw && !mHeadless && mBackBuffer.ready())
+        mBackBuffer.free();
+    invalidate(true);
+}
+
+void Screen::invalidateRect(const Vector2i &pos, const Vector2i &size) {
+    /* Window drop shadows and popup anchors extend beyond the widget bounds */
+    int margin = std::max(mTheme ? mTheme->mWindowDropShadowSize : 0, 15);
+    Vector2i p0 = pos - Vector2i::Constant(margin),
+             p1 = pos + size + Vector2i::Constant(margin);
+
+    if (mRedraw) {
+        mDamageMin = mDamageMin.cwiseMin(p0);
+        mDamageMax = mDamageMax.cwiseMax(p1);
+    } else {
+        mDamageMin = p0;
+        mDamageMax = p1;
+    }
+    mRedraw = true;
+}
+
+double Screen::time() const {
+    return mClock ? mClock() : glfwGetTime();
+}
+
+void Screen::scheduleRedraw(Widget *widget, double time) {
+    /* Don't keep a reference to the screen itself (nullptr stands for it) */
+    if (widget == this)
+        widget = nullptr;
+
+    /* A target has at most one pending deadline, the one requested last */
+    auto it = mDeadlineIndex.find(widget);
+    if (it != mDeadlineIndex.end()) {
+        mDeadlines.erase(it->second);
+        it->second = mDeadlines.emplace(time, widget);
+    } else {
+        mDeadlineIndex.emplace(widget, mDeadlines.emplace(time, widget));
+    }
+}
+
+double Screen::nextDeadline() const {
+    double deadline = mDeadlines.empty() ? std::numeric_limits<double>::infinity()
+                                         : mDeadlines.begin()->first;
+    return std::min(deadline, mTooltipDeadline);
+}
+
+void Screen::processDeadlines(double now) {
+    while (!mDeadlines.empty() && mDeadlines.begin()->first <= now) {
+        ref<Widget> widget = mDeadlines.begin()->second;
+        mDeadlineIndex.erase(widget.get());
+        mDeadlines.erase(mDeadlines.begin());
+        if (widget)
+            widget->invalidate();
+        else
+            invalidate();
+    }
+
+    if (mTooltipDeadline <= now) {
+        mTooltipDeadline = std::numeric_limits<double>::infinity();
+        const Widget *widget = findWidget(mMousePos);
+        if (widget && !widget->tooltip().empty())
+            invalidateTooltip(widget);
+    }
+}
+
+void Screen::postToUI(std::function<void()> task) {
+    if (mTasks.push(std::move(task)))
+        glfwPostEmptyEvent();
+}
+
+size_t Screen::processTasks() {
+    try {
+        return mTasks.run(mTaskBudget);
+    } catch (const std::exception &e) {
+        std::cerr << "Caught exception in UI task: " << e.what() << std::endl;
+        abort();
+    }
+}
+
 void Screen::drawAll() {
+    /* Dispatch the motion accumulated since the previous frame */
+    flushMotionEvents();
+
+    if (mAutoLayout)
+        updateLayout();
+
+    /* Keep the popups next to their parent windows, which may have been
+       moved by the application or by the layout. This must not happen while
+       drawing, which is why Popup::draw() doesn't take care of it */
+    for (auto child : mChildren) {
+        Window *window = widget_cast<Window>(child);
+        if (window && !widget_cast<Popup>(window))
+            window->refreshRelativePlacement();
+    }
+
+    double frameStart = glfwGetTime();
+
     glClearColor(mBackground[0], mBackground[1], mBackground[2], mBackground[3]);
+
+    if (mPartialRedraw || mHeadless) {
+        Vector2i fbSize;
+        glfwGetFramebufferSize(mGLFWWindow, &fbSize[0], &fbSize[1]);
+
+        /* A new back buffer has undefined contents and must be redrawn entirely */
+        if (!mBackBuffer.ready() || mBackBuffer.size() != fbSize) {
+            if (mBackBuffer.ready())
+                mBackBuffer.free();
+            GLint nSamples = 0;
+            glGetIntegerv(GL_SAMPLES, &nSamples);
+            mBackBuffer.init(fbSize, nSamples);
+            invalidate(true);
+        }
+        mBackBuffer.bind();
+
+        if (mPartialRedraw) {
+            mRepaintMin = mDamageMin.cwiseMax(Vector2i::Zero());
+            mRepaintMax = mDamageMax.cwiseMin(mSize).cwiseMax(mRepaintMin);
+
+            /* Restrict clearing and drawContents() to the damaged region */
+            int x0 = (int) std::floor(mRepaintMin.x() * mPixelRatio),
+                y0 = (int) std::floor(mRepaintMin.y() * mPixelRatio),
+                x1 = std::min((int) std::ceil(mRepaintMax.x() * mPixelRatio), fbSize.x()),
+                y1 = std::min((int) std::ceil(mRepaintMax.y() * mPixelRatio), fbSize.y());
+
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x0, fbSize.y() - y1, std::max(x1 - x0, 0), std::max(y1 - y0, 0));
+        }
+    }
+
+    if (!mPartialRedraw) {
+        mRepaintMin = Vector2i::Zero();
+        mRepaintMax = mSize;
+    }
+
+    /* Cleared before drawing so that widgets may request another frame */
+    mRedraw = false;
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
+    double contentsStart = glfwGetTime();
     drawContents();
+    double contentsTime = glfwGetTime() - contentsStart;
+
     drawWidgets();
 
-    glfwSwapBuffers(mGLFWWindow);
+    if (mPartialRedraw)
+        glDisable(GL_SCISSOR_TEST);
+
+    double swapStart = glfwGetTime();
+    if (mHeadless) {
+        /* Keep the frame in the back buffer for readPixels() */
+        mBackBuffer.release();
+    } else {
+        if (mPartialRedraw) {
+            mBackBuffer.release();
+            mBackBuffer.blit(false);
+        }
+        glfwSwapBuffers(mGLFWWindow);
+    }
+    double frameEnd = glfwGetTime();
+
+    FrameStats::Sample sample;
+    sample[FrameStats::Layout] = (float) (mLayoutTime * 1000);
+    sample[FrameStats::Contents] = (float) (contentsTime * 1000);
+    sample[FrameStats::Draw] = (float) (mDrawTime * 1000);
+    sample[FrameStats::Flush] = (float) (mFlushTime * 1000);
+    sample[FrameStats::Swap] = (float) ((frameEnd - swapStart) * 1000);
+    sample[FrameStats::Total] = (float) ((mLayoutTime + frameEnd - frameStart) * 1000);
+    mFrameStats.record(sample);
+    mLayoutTime = 0;
+}
+
+/* Subtrees with fewer widgets are measured by a single thread */
+static const size_t ConcurrentMeasureMinWidgets = 64;
+
+/* Fills the preferred size caches of the widget tree using a thread pool */
+struct ConcurrentMeasure {
+    ThreadPool &pool;
+    std::unordered_map<const Widget *, size_t> widgetCount;
+
+    ConcurrentMeasure(ThreadPool &pool) : pool(pool) { }
+
+    size_t count(const Widget *widget) {
+        size_t result = 1;
+        for (auto child : widget->children())
+            result += count(child);
+        widgetCount[widget] = result;
+        return result;
+    }
+
+    void measureChildren(const Widget *widget, bool all) {
+        std::vector<const Widget *> children;
+        for (auto child : widget->children())
+            if (all || widgetCount.at(child) >= ConcurrentMeasureMinWidgets)
+                children.push_back(child);
+        pool.parallelFor(children.size(), [&](size_t i) { measure(children[i]); });
+    }
+
+    void measure(const Widget *widget) {
+        measureChildren(widget, false);
+        try {
+            widget->cachedPreferredSize(nullptr);
+        } catch (const std::exception &) {
+            /* Left to the layout pass on the calling thread */
+        }
+    }
+};
+
+void Screen::performLayout() {
+    double start = glfwGetTime();
+    if (mLayoutPool && !Profiler::active()) {
+        ConcurrentMeasure measure(*mLayoutPool);
+        measure.count(this);
+        measure.measureChildren(this, true);
+    }
+    Widget::performLayout(mNVGContext);
+    clearLayoutDirty();
+    mLayoutTime += glfwGetTime() - start;
+}
+
+int Screen::layoutThreads() const {
+    return mLayoutPool ? (int) mLayoutPool->threadCount() + 1 : 1;
 }
 
+void Screen::setLayoutThreads(int threads) {
+    if (threads == layoutThreads())
+        return;
+    mLayoutPool.reset(threads > 1 ? new ThreadPool((size_t) threads - 1) : nullptr);
+}
+
+void Screen::updateLayout() {
+    double start = glfwGetTime();
+    Widget::updateLayout(mNVGContext);
+    mLayoutTime += glfwGetTime() - start;
+}
+
+std::vector<uint8_t> Screen::readPixels() {
+    glfwMakeContextCurrent(mGLFWWindow);
+
+    Vector2i size = mFBSize;
+    if (mBackBuffer.ready()) {
+        size = mBackBuffer.size();
+        mBackBuffer.bind();
+    } else {
+        /* The back buffer is undefined after glfwSwapBuffers() */
+        glReadBuffer(GL_FRONT);
+    }
+
+    std::vector<uint8_t> pixels((size_t) size.prod() * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, size.x(), size.y(), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    if (mBackBuffer.ready())
+        mBackBuffer.release();
+    else
+        glReadBuffer(GL_BACK);
+
+    /* OpenGL stores the bottom row first */
+    size_t rowSize = (size_t) size.x() * 4;
+    for (int y = 0; y < size.y() / 2; ++y)
+        std::swap_ranges(pixels.begin() + y * rowSize,
+                         pixels.begin() + (y + 1) * rowSize,
+                         pixels.begin() + (size.y() - 1 - y) * rowSize);
+
+    return pixels;
+}
+
+void Screen::draw(NVGcontext *ctx) {
+    if (!mPartialRedraw) {
+        Widget::draw(ctx);
+        return;
+    }
+
+    int margin = std::max(mTheme->mWindowDropShadowSize, 15);
+    for (auto child : mChildren) {
+        if (!child->visible())
+            continue;
+        Vector2i p0 = child->position() - Vector2i::Constant(margin),
+                 p1 = child->position() + child->size() + Vector2i::Constant(margin);
+        if ((p1.array() <= mRepaintMin.array()).any() ||
+            (p0.array() >= mRepaintMax.array()).any())
+            continue;
+        Profiler::draw(child, ctx);
+    }
+}
+
+/* Maximum width of a line of tooltip text */
+static const int TooltipWidth = 150;
+
 void Screen::drawWidgets() {
     if (!mVisible)
         return;
@@ -384,16 +713,35 @@ void Screen::drawWidgets() {
     glBindSampler(0, 0);
     nvgBeginFrame(mNVGContext, mSize[0], mSize[1], mPixelRatio);
 
-    draw(mNVGContext);
+    if (mPartialRedraw) {
+        Vector2i repaintSize = mRepaintMax - mRepaintMin;
+        nvgScissor(mNVGContext, mRepaintMin.x(), mRepaintMin.y(),
+                   repaintSize.x(), repaintSize.y());
+    }
 
-    double elapsed = glfwGetTime() - mLastInteraction;
+    double drawStart = glfwGetTime();
+    {
+        /* Lets Widget::draw() skip everything outside of the repainted region */
+        Vector2i clipMin = mPartialRedraw ? mRepaintMin : Vector2i::Zero(),
+                 clipMax = mPartialRedraw ? mRepaintMax : mSize;
+        ClipScope clip(mNVGContext, clipMin.cast<float>(), (clipMax - clipMin).cast<float>());
+        Profiler::draw(this, mNVGContext);
+    }
 
-    if (elapsed > 0.5f) {
-        /* Draw tooltips */
-        const Widget *widget = findWidget(mMousePos);
-        if (widget && !widget->tooltip().empty()) {
-            int tooltipWidth = 150;
+    double elapsed = time() - mLastInteraction;
 
+    /* Draw tooltips */
+    const Widget *widget = findWidget(mMousePos);
+    if (widget && !widget->tooltip().empty()) {
+        /* Wake up when the tooltip starts to fade in, then animate it. Only
+           the tooltip is damaged (see processDeadlines()) */
+        if (elapsed < 0.5)
+            mTooltipDeadline = mLastInteraction + 0.5;
+        else if (elapsed < 1.0)
+            mTooltipDeadline = time() + 1.0 / 60.0;
+
+        if (elapsed > 0.5f) {
+            /* Measured by NanoVG, which rounds glyphs at the scale of the framebuffer */
             float bounds[4];
             nvgFontFace(mNVGContext, "sans");
             nvgFontSize(mNVGContext, 15.0f);
@@ -405,9 +753,9 @@ void Screen::drawWidgets() {
             nvgTextBounds(mNVGContext, pos.x(), pos.y(),
                             widget->tooltip().c_str(), nullptr, bounds);
             int h = (bounds[2] - bounds[0]) / 2;
-            if (h > tooltipWidth / 2) {
+            if (h > TooltipWidth / 2) {
                 nvgTextAlign(mNVGContext, NVG_ALIGN_CENTER | NVG_ALIGN_TOP);
-                nvgTextBoxBounds(mNVGContext, pos.x(), pos.y(), tooltipWidth,
+                nvgTextBoxBounds(mNVGContext, pos.x(), pos.y(), TooltipWidth,
                                 widget->tooltip().c_str(), nullptr, bounds);
 
                 h = (bounds[2] - bounds[0]) / 2;
@@ -429,12 +777,15 @@ void Screen::drawWidgets() {
 
             nvgFillColor(mNVGContext, Color(255, 255));
             nvgFontBlur(mNVGContext, 0.0f);
-            nvgTextBox(mNVGContext, pos.x() - h, pos.y(), tooltipWidth,
+            nvgTextBox(mNVGContext, pos.x() - h, pos.y(), TooltipWidth,
                        widget->tooltip().c_str(), nullptr);
         }
     }
 
+    double flushStart = glfwGetTime();
+    mDrawTime = flushStart - drawStart;
     nvgEndFrame(mNVGContext);
+    mFlushTime = glfwGetTime() - flushStart;
 }
 
 bool Screen::keyboardEvent(int key, int scancode, int action, int modifiers) {
@@ -457,6 +808,37 @@ bool Screen::keyboardCharacterEvent(unsigned int codepoint) {
 }
 
 bool Screen::cursorPosCallbackEvent(double x, double y) {
+    if (mEventRecorder) {
+        RecordedEvent e;
+        e.type = RecordedEvent::Type::CursorPos;
+        e.x = x; e.y = y;
+        mEventRecorder->record(e);
+    }
+
+    if (mCoalesceMotion) {
+        /* Deliver only the most recent position, see flushMotionEvents() */
+        mPendingMotionX = x;
+        mPendingMotionY = y;
+        mMotionPending = true;
+        return false;
+    }
+    return dispatchCursorPos(x, y);
+}
+
+void Screen::setCoalesceMotion(bool coalesceMotion) {
+    if (!coalesceMotion)
+        flushMotionEvents();
+    mCoalesceMotion = coalesceMotion;
+}
+
+bool Screen::flushMotionEvents() {
+    if (!mMotionPending)
+        return false;
+    mMotionPending = false;
+    return dispatchCursorPos(mPendingMotionX, mPendingMotionY);
+}
+
+bool Screen::dispatchCursorPos(double x, double y) {
     Vector2i p((int) x, (int) y);
 
 #if defined(_WIN32) || defined(__linux__)
@@ -464,7 +846,10 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
 #endif
 
     bool ret = false;
-    mLastInteraction = glfwGetTime();
+    /* Motion by itself only damages the widgets whose appearance it changes
+       (see Widget::mouseEnterEvent()), the drag target and the tooltip */
+    invalidateTooltip();
+    mLastInteraction = time();
     try {
         p -= Vector2i(1, 2);
 
@@ -478,6 +863,8 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
             ret = mDragWidget->mouseDragEvent(
                 p - mDragWidget->parent()->absolutePosition(), p - mMousePos,
                 mMouseState, mModifiers);
+            /* Dragging usually changes the target (e.g. the value of a slider) */
+            mDragWidget->invalidate();
         }
 
         if (!ret)
@@ -492,13 +879,42 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
     }
 }
 
+void Screen::invalidateTooltip() {
+    /* Tooltips start to fade in after half a second without interaction */
+    if (time() - mLastInteraction <= 0.5)
+        return;
+    const Widget *widget = findWidget(mMousePos);
+    if (widget && !widget->tooltip().empty())
+        invalidateTooltip(widget);
+}
+
+void Screen::invalidateTooltip(const Widget *widget) {
+    /* Bounds of the tooltip box and arrow drawn by draw(). NanoVG measures at
+       the scale of the framebuffer and may wrap into one more row */
+    auto box = TextLayoutCache::instance().layout("sans", 15.0f, widget->tooltip(), TooltipWidth);
+    size_t rows = box->rows.size() + 1;
+    Vector2i pos = widget->absolutePosition() +
+                   Vector2i(widget->width() / 2, widget->height() + 10);
+    int height = (int) std::ceil(box->lineHeight * (1.f + 1.1f * (rows - 1))) + 4;
+    invalidateRect(pos - Vector2i(TooltipWidth / 2 + 5, 10),
+                   Vector2i(TooltipWidth + 10, height + 10));
+}
+
 bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
+    if (mEventRecorder) {
+        RecordedEvent e;
+        e.type = RecordedEvent::Type::MouseButton;
+        e.args[0] = button; e.args[1] = action; e.args[2] = modifiers;
+        mEventRecorder->record(e);
+    }
+    flushMotionEvents();
     mModifiers = modifiers;
-    mLastInteraction = glfwGetTime();
+    mLastInteraction = time();
+    invalidate();
     try {
         if (mFocusPath.size() > 1) {
             const Window *window =
-                dynamic_cast<Window *>(mFocusPath[mFocusPath.size() - 2]);
+                widget_cast<Window>(mFocusPath[mFocusPath.size() - 2]);
             if (window && window->modal()) {
                 if (!window->contains(mMousePos))
                     return false;
@@ -543,7 +959,15 @@ bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
 }
 
 bool Screen::keyCallbackEvent(int key, int scancode, int action, int mods) {
-    mLastInteraction = glfwGetTime();
+    if (mEventRecorder) {
+        RecordedEvent e;
+        e.type = RecordedEvent::Type::Key;
+        e.args[0] = key; e.args[1] = scancode; e.args[2] = action; e.args[3] = mods;
+        mEventRecorder->record(e);
+    }
+    flushMotionEvents();
+    mLastInteraction = time();
+    invalidate();
     try {
         return keyboardEvent(key, scancode, action, mods);
     } catch (const std::exception &e) {
@@ -553,7 +977,15 @@ bool Screen::keyCallbackEvent(int key, int scancode, int action, int mods) {
 }
 
 bool Screen::charCallbackEvent(unsigned int codepoint) {
-    mLastInteraction = glfwGetTime();
+    if (mEventRecorder) {
+        RecordedEvent e;
+        e.type = RecordedEvent::Type::Char;
+        e.args[0] = (int) codepoint;
+        mEventRecorder->record(e);
+    }
+    flushMotionEvents();
+    mLastInteraction = time();
+    invalidate();
     try {
         return keyboardCharacterEvent(codepoint);
     } catch (const std::exception &e) {
@@ -564,6 +996,14 @@ bool Screen::charCallbackEvent(unsigned int codepoint) {
 }
 
 bool Screen::dropCallbackEvent(int count, const char **filenames) {
+    if (mEventRecorder) {
+        RecordedEvent e;
+        e.type = RecordedEvent::Type::Drop;
+        e.filenames.assign(filenames, filenames + count);
+        mEventRecorder->record(e);
+    }
+    flushMotionEvents();
+    invalidate();
     std::vector<std::string> arg(count);
     for (int i = 0; i < count; ++i)
         arg[i] = filenames[i];
@@ -571,11 +1011,19 @@ bool Screen::dropCallbackEvent(int count, const char **filenames) {
 }
 
 bool Screen::scrollCallbackEvent(double x, double y) {
-    mLastInteraction = glfwGetTime();
+    if (mEventRecorder) {
+        RecordedEvent e;
+        e.type = RecordedEvent::Type::Scroll;
+        e.x = x; e.y = y;
+        mEventRecorder->record(e);
+    }
+    flushMotionEvents();
+    mLastInteraction = time();
+    invalidate();
     try {
         if (mFocusPath.size() > 1) {
             const Window *window =
-                dynamic_cast<Window *>(mFocusPath[mFocusPath.size() - 2]);
+                widget_cast<Window>(mFocusPath[mFocusPath.size() - 2]);
             if (window && window->modal()) {
                 if (!window->contains(mMousePos))
                     return false;
@@ -602,7 +1050,14 @@ bool Screen::resizeCallbackEvent(int, int) {
         return false;
 
     mFBSize = fbSize; mSize = size;
-    mLastInteraction = glfwGetTime();
+    if (mEventRecorder) {
+        RecordedEvent e;
+        e.type = RecordedEvent::Type::Resize;
+        e.args[0] = size.x(); e.args[1] = size.y();
+        mEventRecorder->record(e);
+    }
+    mLastInteraction = time();
+    invalidate();
 
     try {
         return resizeEvent(mSize);
@@ -623,12 +1078,13 @@ void Screen::updateFocus(Widget *widget) {
     Widget *window = nullptr;
     while (widget) {
         mFocusPath.push_back(widget);
-        if (dynamic_cast<Window *>(widget))
+        if (widget_cast<Window>(widget))
             window = widget;
         widget = widget->parent();
     }
     for (auto it = mFocusPath.rbegin(); it != mFocusPath.rend(); ++it)
         (*it)->focusEvent(true);
+    invalidate();
 
     if (window)
         moveWindowToFront((Window *) window);
@@ -642,34 +1098,80 @@ void Screen::disposeWindow(Window *window) {
     removeChild(window);
 }
 
+Widget *Screen::findById(const std::string &id) const {
+    auto it = mIdIndex.find(id);
+    return it != mIdIndex.end() ? it->second : nullptr;
+}
+
+void Screen::registerId(Widget *widget) {
+    if (widget->id().empty())
+        return;
+    mIdIndex.emplace(widget->id(), widget);
+    mIdVersion++;
+}
+
+void Screen::unregisterId(Widget *widget) {
+    if (widget->id().empty())
+        return;
+    auto range = mIdIndex.equal_range(widget->id());
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == widget) {
+            mIdIndex.erase(it);
+            mIdVersion++;
+            break;
+        }
+    }
+}
+
+void Screen::registerIds(Widget *widget) {
+    registerId(widget);
+    for (auto child : widget->children())
+        registerIds(child);
+}
+
+void Screen::unregisterIds(Widget *widget) {
+    unregisterId(widget);
+    for (auto child : widget->children())
+        unregisterIds(child);
+}
+
 void Screen::centerWindow(Window *window) {
     if (window->size() == Vector2i::Zero()) {
-        window->setSize(window->preferredSize(mNVGContext));
-        window->performLayout(mNVGContext);
+        window->setSize(window->cachedPreferredSize(mNVGContext));
+        Profiler::performLayout(window, mNVGContext);
     }
     window->setPosition((mSize - window->size()) / 2);
+    window->refreshRelativePlacement();
+}
+
+/* Append the given window and (recursively) the popups attached to it in drawing order */
+static void collectWindowGroup(Screen *screen, Window *window, std::vector<Widget *> &group) {
+    if (window->parent() == screen)
+        group.push_back(window);
+    for (auto popup : window->popups())
+        collectWindowGroup(screen, popup, group);
 }
 
 void Screen::moveWindowToFront(Window *window) {
-    mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), window), mChildren.end());
-    mChildren.push_back(window);
-    /* Brute force topological sort (no problem for a few windows..) */
-    bool changed = false;
-    do {
-        size_t baseIndex = 0;
-        for (size_t index = 0; index < mChildren.size(); ++index)
-            if (mChildren[index] == window)
-                baseIndex = index;
-        changed = false;
-        for (size_t index = 0; index < mChildren.size(); ++index) {
-            Popup *pw = dynamic_cast<Popup *>(mChildren[index]);
-            if (pw && pw->parentWindow() == window && index < baseIndex) {
-                moveWindowToFront(pw);
-                changed = true;
-                break;
-            }
-        }
-    } while (changed);
+    std::vector<Widget *> group;
+    collectWindowGroup(this, window, group);
+    if (group.empty())
+        return;
+
+    /* Nothing to do if the window and its popups are already in front, which
+       is the common case when clicking repeatedly into the same window */
+    if (group.size() <= mChildren.size() &&
+        std::equal(group.begin(), group.end(), mChildren.end() - group.size()))
+        return;
+
+    /* Move the group to the end of the list of children in a single pass */
+    mChildren.erase(std::remove_if(mChildren.begin(), mChildren.end(),
+        [&](Widget *w) { return std::find(group.begin(), group.end(), w) != group.end(); }),
+        mChildren.end());
+    for (auto w : group)
+        mChildren.push_back(w);
+    mHitGridDirty = true;
+    invalidate();
 }
 
 NAMESPACE_END(nanogui)
@@ -13,6 +13,7 @@
 */
 
 #include <nanogui/stackedwidget.h>
+#include <nanogui/profiler.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -35,14 +36,14 @@ void StackedWidget::performLayout(NVGcontext *ctx) {
     for (auto child : mChildren) {
         child->setPosition(Vector2i::Zero());
         child->setSize(mSize);
-        child->performLayout(ctx);
+        Profiler::performLayout(child, ctx);
     }
 }
 
 Vector2i StackedWidget::preferredSize(NVGcontext *ctx) const {
     Vector2i size = Vector2i::Zero();
     for (auto child : mChildren)
-        size = size.cwiseMax(child->preferredSize(ctx));
+        size = size.cwiseMax(child->cachedPreferredSize(ctx));
     return size;
 }
 
@@ -0,0 +1,479 @@
+/*
+    src/tableview.cpp -- Scrollable table that draws the visible cells
+    of a column-oriented data source
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/tableview.h>
+#include <nanogui/screen.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/entypo.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Thrown by the background thread to abandon a query that was superseded */
+struct QueryCancelled { };
+
+/* Number of rows or comparisons between checks for cancellation */
+static const size_t CancellationInterval = 1 << 16;
+
+TableView::TableView(Widget *parent)
+    : Widget(parent), mRowHeight(25), mSortColumn(-1), mSortAscending(true),
+      mScroll(Vector2i::Zero()), mResizeColumn(-1), mQueryValid(false),
+      mShutdown(false), mGeneration(0), mBusy(false),
+      mSelf(std::make_shared<TableView *>(this)) { }
+
+TableView::~TableView() {
+    *mSelf = nullptr;
+    if (mWorker.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            mShutdown = true;
+            mGeneration++;
+        }
+        mCondition.notify_one();
+        mWorker.join();
+    }
+}
+
+void TableView::addColumn(const std::string &title, std::shared_ptr<TableColumn> column, int width) {
+    mColumns.push_back(Column { title, std::move(column), width });
+    invalidatePreferredSize();
+    reload();
+}
+
+void TableView::clearColumns() {
+    mColumns.clear();
+    mSortColumn = -1;
+    invalidatePreferredSize();
+    reload();
+}
+
+void TableView::setColumnWidth(int index, int width) {
+    Column &column = mColumns.at(index);
+    width = std::max(width, 20);
+    if (column.width == width)
+        return;
+    column.width = width;
+    clampScroll();
+    invalidatePreferredSize();
+    invalidate();
+}
+
+void TableView::setSortColumn(int column, bool ascending) {
+    if (column >= (int) mColumns.size())
+        throw std::runtime_error("TableView::setSortColumn(): invalid column index!");
+    mSortColumn = column;
+    mSortAscending = ascending;
+    submitQuery();
+}
+
+void TableView::setFilter(const Filter &filter) {
+    mFilter = filter;
+    submitQuery();
+}
+
+void TableView::reload() {
+    submitQuery();
+}
+
+size_t TableView::rowCount() const {
+    if (mColumns.empty())
+        return 0;
+    size_t count = std::numeric_limits<size_t>::max();
+    for (const Column &column : mColumns)
+        count = std::min(count, column.data->size());
+    return count;
+}
+
+size_t TableView::visibleRowCount() const {
+    return mPermutation ? mPermutation->rows.size() : rowCount();
+}
+
+size_t TableView::dataRow(size_t row) const {
+    return mPermutation ? mPermutation->rows[row] : row;
+}
+
+void TableView::setScrollOffset(int offset) {
+    mScroll.y() = offset;
+    clampScroll();
+    invalidate();
+}
+
+void TableView::submitQuery() {
+    uint64_t generation = ++mGeneration;
+    invalidate();
+
+    size_t rowCount = this->rowCount();
+    if (mSortColumn < 0 && !mFilter) {
+        /* The original order needs no work; cancel whatever is in progress */
+        mPermutation = nullptr;
+        mBusy = false;
+        clampScroll();
+        return;
+    }
+    if (rowCount > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("TableView: too many rows to sort or filter!");
+
+    Query query;
+    for (const Column &column : mColumns)
+        query.columns.push_back(column.data);
+    query.rowCount = rowCount;
+    query.sortColumn = mSortColumn;
+    query.sortAscending = mSortAscending;
+    query.filter = mFilter;
+    query.generation = generation;
+    query.screen = screen();
+
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mQuery = std::move(query);
+        mQueryValid = true;
+    }
+    if (!mWorker.joinable())
+        mWorker = std::thread([this]() { worker(); });
+    mCondition.notify_one();
+    mBusy = true;
+}
+
+void TableView::collectQuery() {
+    if (!mBusy)
+        return;
+    std::shared_ptr<const Permutation> result =
+        std::atomic_exchange(&mResult, std::shared_ptr<const Permutation>());
+    /* A superseded query is followed by the result of the current one */
+    if (!result || result->generation != mGeneration)
+        return;
+    if (!result->failed)
+        mPermutation = result;
+    mBusy = false;
+    clampScroll();
+    invalidate();
+}
+
+void TableView::worker() {
+    while (true) {
+        Query query;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mShutdown || mQueryValid; });
+            if (mShutdown)
+                return;
+            query = std::move(mQuery);
+            mQueryValid = false;
+        }
+        runQuery(query);
+    }
+}
+
+void TableView::runQuery(const Query &query) {
+    std::shared_ptr<Permutation> result = std::make_shared<Permutation>();
+    result->generation = query.generation;
+    result->failed = false;
+
+    auto checkCancelled = [&]() {
+        if (mGeneration.load(std::memory_order_relaxed) != query.generation)
+            throw QueryCancelled();
+    };
+
+    try {
+        std::vector<uint32_t> &rows = result->rows;
+        rows.reserve(query.filter ? 0 : query.rowCount);
+        for (size_t i = 0; i < query.rowCount; ++i) {
+            if (i % CancellationInterval == 0)
+                checkCancelled();
+            if (!query.filter || query.filter(i))
+                rows.push_back((uint32_t) i);
+        }
+
+        if (query.sortColumn >= 0) {
+            const TableColumn &column = *query.columns[query.sortColumn];
+            bool ascending = query.sortAscending;
+            size_t comparisons = 0;
+            std::stable_sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b) {
+                if (++comparisons % CancellationInterval == 0)
+                    checkCancelled();
+                return ascending ? column.less(a, b) : column.less(b, a);
+            });
+        }
+    } catch (const QueryCancelled &) {
+        return;
+    } catch (const std::exception &e) {
+        std::cerr << "Caught exception while sorting or filtering a table: "
+                  << e.what() << std::endl;
+        result->rows.clear();
+        result->failed = true;
+    }
+
+    std::atomic_store(&mResult, std::shared_ptr<const Permutation>(std::move(result)));
+
+    /* Wake up the user interface instead of letting it poll for the result */
+    if (query.screen) {
+        std::shared_ptr<TableView *> self = mSelf;
+        query.screen->postToUI([self]() {
+            if (*self)
+                (*self)->collectQuery();
+        });
+    }
+}
+
+int TableView::contentWidth() const {
+    int width = 0;
+    for (const Column &column : mColumns)
+        width += column.width;
+    return width;
+}
+
+Vector2i TableView::viewSize() const {
+    int height = mSize.y() - mRowHeight;
+    bool scrollbar = (int64_t) visibleRowCount() * mRowHeight > height;
+    return Vector2i(mSize.x() - (scrollbar ? 12 : 0), height).cwiseMax(Vector2i::Zero());
+}
+
+void TableView::clampScroll() {
+    Vector2i view = viewSize();
+    int64_t height = (int64_t) visibleRowCount() * mRowHeight;
+    mScroll.x() = std::max(0, std::min(mScroll.x(), contentWidth() - view.x()));
+    mScroll.y() = (int) std::max((int64_t) 0, std::min((int64_t) mScroll.y(), height - view.y()));
+}
+
+int TableView::columnAt(int x) const {
+    x += mScroll.x();
+    for (size_t i = 0; i < mColumns.size(); ++i) {
+        if (x < mColumns[i].width)
+            return x >= 0 ? (int) i : -1;
+        x -= mColumns[i].width;
+    }
+    return -1;
+}
+
+int TableView::columnEdgeAt(int x) const {
+    int edge = -mScroll.x();
+    for (size_t i = 0; i < mColumns.size(); ++i) {
+        edge += mColumns[i].width;
+        if (std::abs(x - edge) <= 3)
+            return (int) i;
+    }
+    return -1;
+}
+
+Vector2i TableView::preferredSize(NVGcontext *) const {
+    return Vector2i(contentWidth() + 12, 11 * mRowHeight);
+}
+
+bool TableView::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
+    Widget::mouseButtonEvent(p, button, down, modifiers);
+    if (button != GLFW_MOUSE_BUTTON_1)
+        return false;
+
+    Vector2i local = p - mPos;
+    if (!down) {
+        mResizeColumn = -1;
+        return true;
+    }
+    if (local.y() < mRowHeight) {
+        mResizeColumn = columnEdgeAt(local.x());
+        if (mResizeColumn < 0) {
+            int column = columnAt(local.x());
+            if (column >= 0)
+                setSortColumn(column, column == mSortColumn ? !mSortAscending : true);
+        }
+    }
+    return true;
+}
+
+bool TableView::mouseMotionEvent(const Vector2i &p, const Vector2i &, int, int) {
+    Vector2i local = p - mPos;
+    bool onEdge = mResizeColumn >= 0 ||
+        (local.y() < mRowHeight && columnEdgeAt(local.x()) >= 0);
+    setCursor(onEdge ? Cursor::HResize : Cursor::Arrow);
+    return false;
+}
+
+bool TableView::mouseDragEvent(const Vector2i &, const Vector2i &rel, int, int) {
+    if (mResizeColumn >= 0) {
+        setColumnWidth(mResizeColumn, mColumns[mResizeColumn].width + rel.x());
+        return true;
+    }
+
+    Vector2i view = viewSize();
+    int64_t height = (int64_t) visibleRowCount() * mRowHeight;
+    if (height > view.y()) {
+        float scrollh = std::max(view.y() * std::min(1.0f, view.y() / (float) height),
+                                 std::min(20.0f, view.y() - 8.0f));
+        setScrollOffset(mScroll.y() + (int) std::round(
+            rel.y() * (height - view.y()) / (float) (view.y() - 8 - scrollh)));
+    }
+    return true;
+}
+
+bool TableView::scrollEvent(const Vector2i &, const Vector2f &rel) {
+    mScroll -= Vector2i((int) std::round(rel.x() * 30), (int) std::round(rel.y() * mRowHeight * 3));
+    clampScroll();
+    invalidate();
+    return true;
+}
+
+void TableView::draw(NVGcontext *ctx) {
+    Widget::draw(ctx);
+    /* Only needed if the table had no screen when the query was submitted */
+    collectQuery();
+
+    Vector2i view = viewSize();
+    size_t count = visibleRowCount(), rowCount = this->rowCount();
+    int64_t height = (int64_t) count * mRowHeight;
+    int x0 = mPos.x() - mScroll.x(), top = mPos.y() + mRowHeight;
+
+    auto rowTop = [&](size_t row) { return top + (int) ((int64_t) row * mRowHeight - mScroll.y()); };
+
+    /* Range of rows that intersect the view */
+    size_t first = mRowHeight > 0 ? (size_t) (mScroll.y() / mRowHeight) : 0;
+    size_t last = mRowHeight > 0 ? std::min(count,
+        (size_t) ((mScroll.y() + view.y() + mRowHeight - 1) / mRowHeight)) : 0;
+
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, mPos.x(), mPos.y(), view.x(), mSize.y());
+
+    /* Alternating row backgrounds */
+    nvgBeginPath(ctx);
+    for (size_t row = first | 1; row < last; row += 2)
+        nvgRect(ctx, mPos.x(), rowTop(row), view.x(), mRowHeight);
+    nvgFillColor(ctx, Color(255, 8));
+    nvgFill(ctx);
+
+    /* Cells of the visible columns */
+    nvgFontFace(ctx, "sans");
+    nvgFontSize(ctx, fontSize());
+    nvgFillColor(ctx, mEnabled ? mTheme->mTextColor : mTheme->mDisabledTextColor);
+    int x = x0;
+    for (const Column &column : mColumns) {
+        if (x + column.width > mPos.x() && x < mPos.x() + view.x()) {
+            bool numeric = column.data->numeric();
+            nvgSave(ctx);
+            nvgIntersectScissor(ctx, x + 4, top, column.width - 8, view.y());
+            nvgTextAlign(ctx, (numeric ? NVG_ALIGN_RIGHT : NVG_ALIGN_LEFT) | NVG_ALIGN_MIDDLE);
+            float tx = numeric ? x + column.width - 4 : x + 4;
+            for (size_t row = first; row < last; ++row) {
+                /* The data may have shrunk since the current permutation was computed */
+                size_t index = dataRow(row);
+                if (index >= rowCount)
+                    continue;
+                float ty = rowTop(row) + mRowHeight * 0.5f;
+                nvgText(ctx, tx, ty, column.data->text(index).c_str(), nullptr);
+            }
+            nvgRestore(ctx);
+        }
+        x += column.width;
+    }
+
+    /* Header, which stays in place when scrolling vertically */
+    NVGpaint bg = nvgLinearGradient(ctx, mPos.x(), mPos.y(), mPos.x(), top,
+                                    mTheme->mButtonGradientTopUnfocused,
+                                    mTheme->mButtonGradientBotUnfocused);
+    nvgBeginPath(ctx);
+    nvgRect(ctx, mPos.x(), mPos.y(), view.x(), mRowHeight);
+    nvgFillPaint(ctx, bg);
+    nvgFill(ctx);
+
+    nvgFontFace(ctx, "sans-bold");
+    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+    x = x0;
+    for (size_t i = 0; i < mColumns.size(); ++i) {
+        const Column &column = mColumns[i];
+        if (x + column.width > mPos.x() && x < mPos.x() + view.x()) {
+            nvgSave(ctx);
+            nvgIntersectScissor(ctx, x + 4, mPos.y(), column.width - 8, mRowHeight);
+            nvgFontFace(ctx, "sans-bold");
+            nvgFillColor(ctx, mTheme->mTextColor);
+            nvgText(ctx, x + 4, mPos.y() + mRowHeight * 0.5f, column.title.c_str(), nullptr);
+            if ((int) i == mSortColumn) {
+                auto icon = utf8(mSortAscending ? ENTYPO_ICON_CHEVRON_SMALL_UP
+                                                : ENTYPO_ICON_CHEVRON_SMALL_DOWN);
+                nvgFontFace(ctx, "icons");
+                nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
+                nvgText(ctx, x + column.width - 4, mPos.y() + mRowHeight * 0.5f, icon.data(), nullptr);
+                nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+            }
+            nvgRestore(ctx);
+        }
+        x += column.width;
+
+        nvgBeginPath(ctx);
+        nvgMoveTo(ctx, x - 0.5f, mPos.y() + 3);
+        nvgLineTo(ctx, x - 0.5f, mPos.y() + mRowHeight - 3);
+        nvgStrokeColor(ctx, mTheme->mBorderDark);
+        nvgStrokeWidth(ctx, 1.0f);
+        nvgStroke(ctx);
+    }
+
+    nvgBeginPath(ctx);
+    nvgMoveTo(ctx, mPos.x(), top - 0.5f);
+    nvgLineTo(ctx, mPos.x() + view.x(), top - 0.5f);
+    nvgStrokeColor(ctx, mTheme->mBorderDark);
+    nvgStroke(ctx);
+    nvgRestore(ctx);
+
+    if (height <= view.y())
+        return;
+
+    /* Vertical scrollbar next to the rows */
+    float scrollh = std::max(view.y() * std::min(1.0f, view.y() / (float) height),
+                             std::min(20.0f, view.y() - 8.0f));
+    float scroll = mScroll.y() / (float) (height - view.y());
+
+    NVGpaint paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 + 1, top + 4 + 1, 8,
+        view.y() - 8, 3, 4, Color(0, 32), Color(0, 92));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12, top + 4, 8,
+                   view.y() - 8, 3);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+
+    paint = nvgBoxGradient(
+        ctx, mPos.x() + mSize.x() - 12 - 1,
+        top + 4 + (view.y() - 8 - scrollh) * scroll - 1, 8, scrollh,
+        3, 4, Color(220, 100), Color(128, 100));
+
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + mSize.x() - 12 + 1,
+                   top + 4 + 1 + (view.y() - 8 - scrollh) * scroll, 8 - 2,
+                   scrollh - 2, 2);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+}
+
+void TableView::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("rowHeight", mRowHeight);
+    s.set("sortColumn", mSortColumn);
+    s.set("sortAscending", mSortAscending);
+    s.set("scroll", mScroll);
+}
+
+bool TableView::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    if (!s.get("rowHeight", mRowHeight)) return false;
+    if (!s.get("sortColumn", mSortColumn)) return false;
+    if (!s.get("sortAscending", mSortAscending)) return false;
+    if (!s.get("scroll", mScroll)) return false;
+    if (mSortColumn >= (int) mColumns.size())
+        mSortColumn = -1;
+    submitQuery();
+    return true;
+}
+
+NAMESPACE_END(nanogui)
@@ -19,6 +19,7 @@
 #include <nanogui/opengl.h>
 #include <nanogui/window.h>
 #include <nanogui/screen.h>
+#include <nanogui/profiler.h>
 #include <algorithm>
 
 NAMESPACE_BEGIN(nanogui)
@@ -118,19 +119,19 @@ const std::string &TabWidget::tabLabelAt(int index) const {
 }
 
 void TabWidget::performLayout(NVGcontext* ctx) {
-    int headerHeight = mHeader->preferredSize(ctx).y();
+    int headerHeight = mHeader->cachedPreferredSize(ctx).y();
     int margin = mTheme->mTabInnerMargin;
     mHeader->setPosition({ 0, 0 });
     mHeader->setSize({ mSize.x(), headerHeight });
-    mHeader->performLayout(ctx);
+    Profiler::performLayout(mHeader, ctx);
     mContent->setPosition({ margin, headerHeight + margin });
     mContent->setSize({ mSize.x() - 2 * margin, mSize.y() - 2*margin - headerHeight });
-    mContent->performLayout(ctx);
+    Profiler::performLayout(mContent, ctx);
 }
 
 Vector2i TabWidget::preferredSize(NVGcontext* ctx) const {
-    auto contentSize = mContent->preferredSize(ctx);
-    auto headerSize = mHeader->preferredSize(ctx);
+    auto contentSize = mContent->cachedPreferredSize(ctx);
+    auto headerSize = mHeader->cachedPreferredSize(ctx);
     int margin = mTheme->mTabInnerMargin;
     auto borderSize = Vector2i(2 * margin, 2 * margin);
     Vector2i tabPreferredSize = contentSize + borderSize + Vector2i(0, headerSize.y());
@@ -138,7 +139,7 @@ Vector2i TabWidget::preferredSize(NVGcontext* ctx) const {
 }
 
 void TabWidget::draw(NVGcontext* ctx) {
-    int tabHeight = mHeader->preferredSize(ctx).y();
+    int tabHeight = mHeader->cachedPreferredSize(ctx).y();
     auto activeArea = mHeader->activeButtonArea();
 
 
@@ -0,0 +1,75 @@
+/*
+    src/taskqueue.cpp -- Lock-free queue of tasks that other threads
+    submit for execution on the user interface thread
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/taskqueue.h>
+#include <chrono>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* This is an intrusive MPSC queue in the style of Dmitry Vyukov: producers
+   atomically swap themselves into the head, while the consumer follows the
+   'next' pointers starting from a stub node at the tail. The node holding the
+   most recently dequeued task becomes the new stub. */
+
+TaskQueue::TaskQueue() : mWakeRequested(false) {
+    Node *stub = new Node();
+    stub->next.store(nullptr, std::memory_order_relaxed);
+    mHead.store(stub, std::memory_order_relaxed);
+    mTail = stub;
+}
+
+TaskQueue::~TaskQueue() {
+    while (mTail) {
+        Node *next = mTail->next.load(std::memory_order_acquire);
+        delete mTail;
+        mTail = next;
+    }
+}
+
+bool TaskQueue::push(std::function<void()> task) {
+    Node *node = new Node();
+    node->task = std::move(task);
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node *prev = mHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+    return !mWakeRequested.exchange(true, std::memory_order_acq_rel);
+}
+
+size_t TaskQueue::run(double budget) {
+    /* Tasks pushed from now on must wake up the consumer again */
+    mWakeRequested.store(false, std::memory_order_release);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t count = 0;
+    while (true) {
+        Node *next = mTail->next.load(std::memory_order_acquire);
+        if (!next)
+            break;
+        delete mTail;
+        mTail = next;
+        std::function<void()> task = std::move(next->task);
+        next->task = nullptr;
+        task();
+        count++;
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budget)
+            break;
+    }
+    return count;
+}
+
+bool TaskQueue::empty() const {
+    return mTail->next.load(std::memory_order_acquire) == nullptr;
+}
+
+NAMESPACE_END(nanogui)
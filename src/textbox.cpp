@@ -17,6 +17,7 @@
 #include <nanogui/textbox.h>
 #include <nanogui/opengl.h>
 #include <nanogui/theme.h>
+#include <nanogui/fontmetrics.h>
 #include <nanogui/entypo.h>
 #include <nanogui/serializer/core.h>
 #include <regex>
@@ -50,6 +51,7 @@ TextBox::TextBox(Widget *parent,const std::string &value)
 
 void TextBox::setEditable(bool editable) {
     mEditable = editable;
+    invalidate();
     setCursor(editable ? Cursor::IBeam : Cursor::Arrow);
 }
 
@@ -64,19 +66,22 @@ Vector2i TextBox::preferredSize(NVGcontext *ctx) const {
 
     float uw = 0;
     if (mUnitsImage > 0) {
+        if (!ctx)
+            throw std::runtime_error("TextBox::preferredSize(): unit images "
+                                     "can only be measured using a NanoVG context!");
         int w, h;
         nvgImageSize(ctx, mUnitsImage, &w, &h);
         float uh = size(1) * 0.4f;
         uw = w * uh / h;
     } else if (!mUnits.empty()) {
-        uw = nvgTextBounds(ctx, 0, 0, mUnits.c_str(), nullptr, nullptr);
+        uw = FontMetrics::instance().textWidth("sans", fontSize(), mUnits);
     }
     float sw = 0;
     if (mSpinnable) {
         sw = 14.f;
     }
 
-    float ts = nvgTextBounds(ctx, 0, 0, mValue.c_str(), nullptr, nullptr);
+    float ts = FontMetrics::instance().textWidth("sans", fontSize(), mValue);
     size(0) = size(1) + ts + uw + sw;
     return size;
 }
@@ -291,7 +296,7 @@ bool TextBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
             mMouseDownPos = p;
             mMouseDownModifier = modifiers;
 
-            double time = glfwGetTime();
+            double time = screen()->time();
             if (time - mLastClick < 0.25) {
                 /* Double-click: select all text */
                 mSelectionPos = 0;
@@ -310,10 +315,11 @@ bool TextBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
                 mMouseDownPos = p;
                 mMouseDownModifier = modifiers;
 
-                double time = glfwGetTime();
+                double time = screen()->time();
                 if (time - mLastClick < 0.25) {
                     /* Double-click: reset to default value */
                     mValue = mDefaultValue;
+                    invalidatePreferredSize();
                     if (mCallback)
                         mCallback(mValue);
 
@@ -336,6 +342,9 @@ bool TextBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
 
 bool TextBox::mouseMotionEvent(const Vector2i &p, const Vector2i & /* rel */,
                                int /* button */, int /* modifiers */) {
+    /* The spin arrows are highlighted while the cursor hovers over them */
+    if (mSpinnable && spinArea(p) != spinArea(mMousePos))
+        invalidate();
     mMousePos = p;
 
     if (!mEditable)
@@ -382,6 +391,7 @@ bool TextBox::focusEvent(bool focused) {
 
             if (mCallback && !mCallback(mValue))
                 mValue = backup;
+            invalidatePreferredSize();
 
             mValidFormat = true;
             mCommitted = true;
@@ -510,7 +520,7 @@ bool TextBox::checkFormat(const std::string &input, const std::string &format) {
 
 bool TextBox::copySelection() {
     if (mSelectionPos > -1) {
-        Screen *sc = dynamic_cast<Screen *>(this->window()->parent());
+        Screen *sc = screen();
 
         int begin = mCursorPos;
         int end = mSelectionPos;
@@ -527,7 +537,7 @@ bool TextBox::copySelection() {
 }
 
 void TextBox::pasteFromClipboard() {
-    Screen *sc = dynamic_cast<Screen *>(this->window()->parent());
+    Screen *sc = screen();
     const char* cbstr = glfwGetClipboardString(sc->glfwWindow());
     if (cbstr)
         mValueTemp.insert(mCursorPos, std::string(cbstr));
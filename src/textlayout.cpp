@@ -0,0 +1,138 @@
+/*
+    src/textlayout.cpp -- Line breaks and glyph positions of a string,
+    and a shared cache of them
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textlayout.h>
+#include <nanogui/fontmetrics.h>
+#include <nanogui/opengl.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+void TextLayout::draw(NVGcontext *ctx, float x, float y, float lineSpacing) const {
+    for (const Row &row : rows) {
+        nvgText(ctx, x, y, text.data() + row.begin, text.data() + row.end);
+        y += lineHeight * lineSpacing;
+    }
+}
+
+size_t TextLayoutCache::hash(const std::string &font, float size,
+                             const std::string &text, float breakWidth) {
+    size_t hash = std::hash<std::string>()(text);
+    hash = hash * 31 + std::hash<std::string>()(font);
+    hash = hash * 31 + std::hash<float>()(size);
+    hash = hash * 31 + std::hash<float>()(breakWidth);
+    return hash;
+}
+
+TextLayoutCache &TextLayoutCache::instance() {
+    static TextLayoutCache instance(FontMetrics::instance());
+    return instance;
+}
+
+TextLayoutCache::TextLayoutCache(const FontMetrics &metrics, size_t capacity)
+    : mMetrics(metrics), mCapacity(capacity), mHits(0), mMisses(0) { }
+
+std::shared_ptr<const TextLayout> TextLayoutCache::layout(const std::string &font, float size,
+                                                          const std::string &text,
+                                                          float breakWidth) {
+    breakWidth = breakWidth > 0.f ? breakWidth : 0.f;
+    size_t hash = TextLayoutCache::hash(font, size, text, breakWidth);
+
+    Future future;
+    std::promise<std::shared_ptr<const TextLayout>> promise;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = find(hash, font, size, text, breakWidth);
+        if (it != mEntries.end()) {
+            mEntries.splice(mEntries.begin(), mEntries, it);
+            mHits++;
+            future = it->layout;
+        } else {
+            /* Publish the pending layout, so that other threads wait for it
+               instead of computing it as well */
+            mMisses++;
+            if (mCapacity > 0) {
+                mEntries.push_front(Entry { text, font, size, breakWidth, hash,
+                                            promise.get_future().share() });
+                mIndex.emplace(hash, mEntries.begin());
+                shrink();
+            }
+        }
+    }
+    if (future.valid())
+        return future.get();
+
+    try {
+        std::shared_ptr<TextLayout> layout = std::make_shared<TextLayout>();
+        mMetrics.layoutText(font, size, breakWidth, text, *layout);
+        promise.set_value(layout);
+        return layout;
+    } catch (...) {
+        /* Waiting threads receive the exception as well */
+        promise.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto it = find(hash, font, size, text, breakWidth);
+        if (it != mEntries.end())
+            erase(it);
+        throw;
+    }
+}
+
+std::list<TextLayoutCache::Entry>::iterator
+TextLayoutCache::find(size_t hash, const std::string &font, float size,
+                      const std::string &text, float breakWidth) {
+    auto range = mIndex.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->matches(font, size, text, breakWidth))
+            return it->second;
+    }
+    return mEntries.end();
+}
+
+void TextLayoutCache::erase(std::list<Entry>::iterator entry) {
+    auto range = mIndex.equal_range(entry->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == entry) {
+            mIndex.erase(it);
+            break;
+        }
+    }
+    mEntries.erase(entry);
+}
+
+size_t TextLayoutCache::capacity() const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return mCapacity;
+}
+
+void TextLayoutCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mCapacity = capacity;
+    shrink();
+}
+
+size_t TextLayoutCache::size() const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return mEntries.size();
+}
+
+void TextLayoutCache::clear() {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mIndex.clear();
+    mEntries.clear();
+}
+
+void TextLayoutCache::shrink() {
+    while (mEntries.size() > mCapacity)
+        erase(std::prev(mEntries.end()));
+}
+
+NAMESPACE_END(nanogui)
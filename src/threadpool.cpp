@@ -0,0 +1,136 @@
+/*
+    src/threadpool.cpp -- Work-stealing thread pool for fork-join
+    parallelism
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/threadpool.h>
+#include <exception>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Pool and queue index of the calling worker thread */
+static thread_local const ThreadPool *currentPool = nullptr;
+static thread_local size_t currentIndex = 0;
+
+ThreadPool::ThreadPool(size_t threadCount) : mPending(0), mShutdown(false) {
+    for (size_t i = 0; i <= threadCount; ++i)
+        mQueues.emplace_back(new Queue());
+    for (size_t i = 0; i < threadCount; ++i)
+        mThreads.emplace_back([this, i]() { worker(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(mSleepMutex);
+        mShutdown = true;
+    }
+    mSleepCondition.notify_all();
+    for (auto &thread : mThreads)
+        thread.join();
+}
+
+size_t ThreadPool::queueIndex() const {
+    return currentPool == this ? currentIndex : mQueues.size() - 1;
+}
+
+void ThreadPool::push(Task task) {
+    Queue &queue = *mQueues[queueIndex()];
+    {
+        std::lock_guard<std::mutex> guard(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    mPending++;
+    {
+        /* Synchronize with workers that are about to go to sleep */
+        std::lock_guard<std::mutex> guard(mSleepMutex);
+    }
+    mSleepCondition.notify_one();
+}
+
+bool ThreadPool::runOne(size_t self) {
+    Task task;
+
+    /* Take the most recent task of our own queue, or else the oldest task of another one */
+    {
+        Queue &queue = *mQueues[self];
+        std::lock_guard<std::mutex> guard(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+    for (size_t i = 1; !task && i < mQueues.size(); ++i) {
+        Queue &queue = *mQueues[(self + i) % mQueues.size()];
+        std::lock_guard<std::mutex> guard(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+        return false;
+    mPending--;
+    task();
+    return true;
+}
+
+void ThreadPool::worker(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        if (runOne(index))
+            continue;
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mSleepCondition.wait(lock, [this]() { return mShutdown || mPending > 0; });
+        if (mShutdown)
+            break;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &func) {
+    if (mThreads.empty() || count < 2) {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    std::atomic<size_t> remaining(count);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto run = [&](size_t i) {
+        try {
+            func(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(errorMutex);
+            if (!error)
+                error = std::current_exception();
+        }
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    for (size_t i = 1; i < count; ++i)
+        push([&run, i]() { run(i); });
+    run(0);
+
+    /* Help out until the other invocations have finished */
+    size_t self = queueIndex();
+    while (remaining.load(std::memory_order_acquire) != 0) {
+        if (!runOne(self))
+            std::this_thread::yield();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+NAMESPACE_END(nanogui)
@@ -13,12 +13,145 @@
 #include <nanogui/vscrollpanel.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+/* Declares the framebuffer utilities of NanoVG, which are compiled into screen.cpp */
+#define NANOVG_GL3
+#include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
+#include <nanogui/profiler.h>
+#include <nanogui/screen.h>
 #include <nanogui/serializer/core.h>
 
 NAMESPACE_BEGIN(nanogui)
 
 VScrollPanel::VScrollPanel(Widget *parent)
-    : Widget(parent), mChildPreferredHeight(0), mScroll(0.0f), mUpdateLayout(false) { }
+    : Widget(parent), mChildPreferredHeight(0), mScroll(0.0f), mCacheContent(false),
+      mCacheValid(false), mMovingChild(false), mContentChanged(false),
+      mContentStable(false), mCacheRendered(false), mCache(nullptr),
+      mCacheSize(Vector2i::Zero()), mCacheTop(0), mCacheHeight(0) { }
+
+VScrollPanel::~VScrollPanel() {
+    freeCache();
+}
+
+void VScrollPanel::setScroll(float scroll) {
+    mScroll = std::max(0.0f, std::min(1.0f, scroll));
+    updateChildPosition();
+}
+
+void VScrollPanel::setCacheContent(bool cacheContent) {
+    mCacheContent = cacheContent;
+    if (!cacheContent)
+        freeCache();
+}
+
+void VScrollPanel::descendantInvalidated() {
+    if (!mMovingChild) {
+        mCacheValid = false;
+        mContentChanged = true;
+    }
+}
+
+void VScrollPanel::updateChildPosition() {
+    if (mChildren.empty())
+        return;
+    /* Moving the child does not change how its contents look */
+    mMovingChild = true;
+    mChildren[0]->setPosition(
+        Vector2i(0, -mScroll * std::max(mChildPreferredHeight - mSize.y(), 0)));
+    mMovingChild = false;
+}
+
+bool VScrollPanel::cacheCoversView() const {
+    if (!mCacheValid || mChildren.empty())
+        return false;
+    int top = -mChildren[0]->position().y();
+    return top >= mCacheTop && top + mSize.y() <= mCacheTop + mCacheHeight;
+}
+
+void VScrollPanel::updateCache() {
+    /* Content that changes from frame to frame (e.g. hover highlights while
+       the cursor crosses rows) is cheaper to draw directly */
+    if (!mCacheContent || mCacheRendered || !mContentStable || cacheCoversView())
+        return;
+    renderCache();
+}
+
+bool VScrollPanel::renderCache() {
+    Screen *screen = this->screen();
+    if (!screen || mChildren.empty() || !mChildren[0]->visible())
+        return false;
+    Widget *child = mChildren[0];
+    NVGcontext *ctx = screen->nvgContext();
+    float pixelRatio = screen->pixelRatio();
+
+    /* The visible part of the child and a margin of one panel height on either side */
+    int top = -child->position().y();
+    int height = std::min(child->height(), 3 * mSize.y());
+    int bandTop = std::max(0, std::min(top - mSize.y(), child->height() - height));
+    Vector2i size(child->width(), height),
+             fbSize = (size.cast<float>() * pixelRatio).array().ceil().matrix().cast<int>();
+
+    glfwMakeContextCurrent(screen->glfwWindow());
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if ((fbSize.array() <= 0).any() || (fbSize.array() > maxSize).any()) {
+        freeCache();
+        return false;
+    }
+    if (mCache && mCacheSize != fbSize)
+        freeCache();
+    if (!mCache) {
+        mCache = nvgluCreateFramebuffer(ctx, fbSize.x(), fbSize.y(), 0);
+        if (!mCache)
+            return false;
+        mCacheSize = fbSize;
+    }
+
+    /* The cache is rendered between frames, while the screen's framebuffer may be bound */
+    GLint framebuffer = 0, viewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+    glDisable(GL_SCISSOR_TEST);
+
+    nvgluBindFramebuffer(mCache);
+    glViewport(0, 0, fbSize.x(), fbSize.y());
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    nvgBeginFrame(ctx, size.x(), size.y(), pixelRatio);
+    Vector2i origin = child->position() + Vector2i(0, bandTop);
+    nvgTranslate(ctx, -origin.x(), -origin.y());
+    {
+        /* Widget::draw() culls the descendants outside of this band */
+        ClipScope clip(ctx, origin.cast<float>(), size.cast<float>());
+        Profiler::draw(child, ctx);
+    }
+    nvgEndFrame(ctx);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    if (scissorTest)
+        glEnable(GL_SCISSOR_TEST);
+
+    mCacheValid = true;
+    mCacheRendered = true;
+    mCacheTop = bandTop;
+    mCacheHeight = height;
+    return true;
+}
+
+void VScrollPanel::freeCache() {
+    mCacheValid = false;
+    if (!mCache)
+        return;
+    /* Otherwise, the screen and its NanoVG context are being destroyed along with the cache */
+    Screen *screen = this->screen();
+    if (screen) {
+        glfwMakeContextCurrent(screen->glfwWindow());
+        nvgluDeleteFramebuffer(mCache);
+    }
+    mCache = nullptr;
+}
 
 void VScrollPanel::performLayout(NVGcontext *ctx) {
     Widget::performLayout(ctx);
@@ -29,23 +162,22 @@ void VScrollPanel::performLayout(NVGcontext *ctx) {
         throw std::runtime_error("VScrollPanel should have one child.");
 
     Widget *child = mChildren[0];
-    mChildPreferredHeight = child->preferredSize(ctx).y();
+    mChildPreferredHeight = child->cachedPreferredSize(ctx).y();
 
     if (mChildPreferredHeight > mSize.y()) {
-        child->setPosition(Vector2i(0, -mScroll*(mChildPreferredHeight - mSize.y())));
         child->setSize(Vector2i(mSize.x()-12, mChildPreferredHeight));
     } else {
-        child->setPosition(Vector2i::Zero());
         child->setSize(mSize);
         mScroll = 0;
     }
-    child->performLayout(ctx);
+    updateChildPosition();
+    Profiler::performLayout(child, ctx);
 }
 
 Vector2i VScrollPanel::preferredSize(NVGcontext *ctx) const {
     if (mChildren.empty())
         return Vector2i::Zero();
-    return mChildren[0]->preferredSize(ctx) + Vector2i(12, 0);
+    return mChildren[0]->cachedPreferredSize(ctx) + Vector2i(12, 0);
 }
 
 bool VScrollPanel::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
@@ -56,7 +188,8 @@ bool VScrollPanel::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
 
         mScroll = std::max((float) 0.0f, std::min((float) 1.0f,
                      mScroll + rel.y() / (float)(mSize.y() - 8 - scrollh)));
-        mUpdateLayout = true;
+        updateChildPosition();
+        updateCache();
         return true;
     } else {
         return Widget::mouseDragEvent(p, rel, button, modifiers);
@@ -71,7 +204,8 @@ bool VScrollPanel::scrollEvent(const Vector2i &p, const Vector2f &rel) {
 
         mScroll = std::max((float) 0.0f, std::min((float) 1.0f,
                 mScroll - scrollAmount / (float)(mSize.y() - 8 - scrollh)));
-        mUpdateLayout = true;
+        updateChildPosition();
+        updateCache();
         return true;
     } else {
         return Widget::scrollEvent(p, rel);
@@ -82,19 +216,31 @@ void VScrollPanel::draw(NVGcontext *ctx) {
     if (mChildren.empty())
         return;
     Widget *child = mChildren[0];
-    child->setPosition(Vector2i(0, -mScroll*(mChildPreferredHeight - mSize.y())));
-    mChildPreferredHeight = child->preferredSize(ctx).y();
     float scrollh = height() *
         std::min(1.0f, height() / (float) mChildPreferredHeight);
 
-    if (mUpdateLayout)
-        child->performLayout(ctx);
+    /* Scroll events may render the cache again once the next frame has
+       started, provided that the content did not change in the meantime */
+    mContentStable = !mContentChanged;
+    mContentChanged = mCacheRendered = false;
 
     nvgSave(ctx);
     nvgTranslate(ctx, mPos.x(), mPos.y());
-    nvgIntersectScissor(ctx, 0, 0, mSize.x(), mSize.y());
-    if (child->visible())
-        child->draw(ctx);
+    {
+        ClipScope clip(ctx, Vector2f::Zero(), mSize.cast<float>());
+        if (child->visible() && cacheCoversView()) {
+            Vector2f pos = (child->position() + Vector2i(0, mCacheTop)).cast<float>(),
+                     size(child->width(), mCacheHeight);
+            NVGpaint paint = nvgImagePattern(ctx, pos.x(), pos.y(), size.x(), size.y(),
+                                             0, mCache->image, 1.0f);
+            nvgBeginPath(ctx);
+            nvgRect(ctx, pos.x(), pos.y(), size.x(), size.y());
+            nvgFillPaint(ctx, paint);
+            nvgFill(ctx);
+        } else if (child->visible()) {
+            Profiler::draw(child, ctx);
+        }
+    }
     nvgRestore(ctx);
 
     if (mChildPreferredHeight <= mSize.y())
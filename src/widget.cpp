@@ -15,16 +15,109 @@
 #include <nanogui/window.h>
 #include <nanogui/opengl.h>
 #include <nanogui/screen.h>
+#include <nanogui/profiler.h>
 #include <nanogui/serializer/core.h>
+#include <nanogui/widgetpool.h>
+#include <cstdint>
+#include <limits>
 
 NAMESPACE_BEGIN(nanogui)
 
+/* A pooled widget is preceded by a header that records its pool and the size
+   of its block. Whether a widget is pooled at all is kept in Widget::mPooled,
+   which the allocation functions and the constructor/destructor hand over
+   through the following thread-local variables. This spares deletions a lookup
+   of the owning pool. */
+struct PoolHeader {
+    WidgetPool *pool;
+    size_t size;
+};
+
+/* A multiple of 16 to preserve the alignment of the blocks of the pool */
+static const size_t PoolHeaderSize = 16;
+static_assert(sizeof(PoolHeader) <= PoolHeaderSize, "PoolHeader is too large");
+
+static thread_local uintptr_t pooledBlock = 0, pooledBlockEnd = 0;
+static thread_local uintptr_t releasedWidget = 0;
+
+static void releasePooledBlock(void *ptr) {
+    PoolHeader *header = (PoolHeader *) ((char *) ptr - PoolHeaderSize);
+    header->pool->deallocate(header, header->size);
+}
+
+/* Uniform grid over the rectangles of the visible children of a widget.
+   Each cell lists the indices of the children overlapping it in ascending
+   order, i.e. bottom to top. */
+struct HitGrid {
+    Vector2i origin, cellSize, cells;
+    std::vector<uint32_t> offsets, indices;
+
+    /// Return the range of child indices whose rectangles may contain p
+    std::pair<const uint32_t *, const uint32_t *> lookup(const Vector2i &p) const {
+        Vector2i c = p - origin;
+        if ((c.array() < 0).any())
+            return { nullptr, nullptr };
+        c = c.cwiseQuotient(cellSize);
+        if ((c.array() >= cells.array()).any())
+            return { nullptr, nullptr };
+        int cell = c.y() * cells.x() + c.x();
+        return { indices.data() + offsets[cell], indices.data() + offsets[cell + 1] };
+    }
+};
+
+/* Widgets with fewer children are hit tested with a linear scan */
+static const size_t HitGridMinChildren = 16;
+
+/* Widgets may draw decorations (e.g. shadows) slightly outside of their bounds */
+static const int ClipMargin = 8;
+
+/* Rectangle of the innermost ClipScope in screen coordinates */
+static Vector2f clipMin = Vector2f::Constant(-std::numeric_limits<float>::infinity()),
+                clipMax = Vector2f::Constant(std::numeric_limits<float>::infinity());
+
+ClipScope::ClipScope(NVGcontext *ctx, const Vector2f &pos, const Vector2f &size)
+    : mContext(ctx), mPrevMin(clipMin), mPrevMax(clipMax) {
+    float xform[6];
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, pos.x(), pos.y(), size.x(), size.y());
+    nvgCurrentTransform(ctx, xform);
+    Vector2f offset(xform[4], xform[5]);
+    clipMin = clipMin.cwiseMax(pos + offset);
+    clipMax = clipMax.cwiseMin(pos + size + offset);
+}
+
+ClipScope::~ClipScope() {
+    clipMin = mPrevMin;
+    clipMax = mPrevMax;
+    nvgRestore(mContext);
+}
+
+void ClipScope::bounds(NVGcontext *ctx, Vector2f &min, Vector2f &max) {
+    /* Widgets only ever translate the coordinate system */
+    float xform[6];
+    nvgCurrentTransform(ctx, xform);
+    Vector2f offset(xform[4], xform[5]);
+    min = clipMin - offset;
+    max = clipMax - offset;
+}
+
 Widget::Widget(Widget *parent)
-    : mParent(nullptr), mTheme(nullptr), mLayout(nullptr),
+    : mTypeTags(0), mVisible(true), mEnabled(true), mFocused(false),
+      mMouseFocus(false), mHitGridDirty(true), mLayoutDirty(true),
+      mSubtreeLayoutDirty(true), mPooled(false), mPreferredSizeValid(false),
+      mAbsolutePosValid(false), mParent(nullptr), mWindow(nullptr),
+      mScreen(nullptr), mTheme(nullptr), mLayout(nullptr),
       mPos(Vector2i::Zero()), mSize(Vector2i::Zero()),
-      mFixedSize(Vector2i::Zero()), mVisible(true), mEnabled(true),
-      mFocused(false), mMouseFocus(false), mTooltip(""), mFontSize(-1.0f),
-      mCursor(Cursor::Arrow) {
+      mFixedSize(Vector2i::Zero()), mPreferredSize(Vector2i::Zero()),
+      mLayoutPreferredSize(Vector2i::Zero()), mFontSize(-1),
+      mCursor(Cursor::Arrow), mIndexInParent(0), mExcludedFromLayout(false) {
+    /* The Widget subobject lies within the block if it was just allocated by
+       operator new(size_t, WidgetPool *) */
+    uintptr_t self = (uintptr_t) this;
+    if (self >= pooledBlock && self < pooledBlockEnd) {
+        mPooled = true;
+        pooledBlock = pooledBlockEnd = 0;
+    }
     if (parent)
         parent->addChild(this);
 }
@@ -34,6 +127,9 @@ Widget::~Widget() {
         if (child)
             child->decRef();
     }
+    /* Tell operator delete() that this widget's block belongs to a pool */
+    if (mPooled)
+        releasedWidget = (uintptr_t) this;
 }
 
 void Widget::setTheme(Theme *theme) {
@@ -42,6 +138,8 @@ void Widget::setTheme(Theme *theme) {
     mTheme = theme;
     for (auto child : mChildren)
         child->setTheme(theme);
+    invalidate();
+    invalidatePreferredSize();
 }
 
 int Widget::fontSize() const {
@@ -55,33 +153,199 @@ Vector2i Widget::preferredSize(NVGcontext *ctx) const {
         return mSize;
 }
 
+Vector2i Widget::cachedPreferredSize(NVGcontext *ctx) const {
+    if (!mPreferredSizeValid) {
+        mPreferredSize = Profiler::preferredSize(this, ctx);
+        mPreferredSizeValid = true;
+    }
+    return mPreferredSize;
+}
+
+void Widget::invalidatePreferredSize() {
+    /* Don't stop at ancestors whose cache is already invalid: their own
+       ancestors may have been measured without consulting them */
+    mPreferredSizeValid = false;
+    for (Widget *widget = mParent; widget && widget->childrenAffectPreferredSize();
+         widget = widget->mParent)
+        widget->mPreferredSizeValid = false;
+    invalidateLayout();
+}
+
+void Widget::invalidateLayout() {
+    mLayoutDirty = true;
+    /* Remember the preferred size that the last layout was based on, which
+       lets updateLayout() decide whether the parent must be laid out too */
+    for (Widget *widget = this; widget && !widget->mSubtreeLayoutDirty; widget = widget->mParent) {
+        widget->mSubtreeLayoutDirty = true;
+        widget->mLayoutPreferredSize = widget->mPreferredSize;
+    }
+}
+
+void Widget::updateLayout(NVGcontext *ctx) {
+    if (!mSubtreeLayoutDirty)
+        return;
+
+    for (size_t i = 0; i < mChildren.size() && !mLayoutDirty; ++i) {
+        Widget *child = mChildren[i];
+        if (child->mSubtreeLayoutDirty &&
+            child->cachedPreferredSize(ctx) != child->mLayoutPreferredSize)
+            mLayoutDirty = true;
+    }
+
+    if (mLayoutDirty) {
+        Profiler::performLayout(this, ctx);
+        clearLayoutDirty();
+    } else {
+        mSubtreeLayoutDirty = false;
+        for (auto child : mChildren)
+            child->updateLayout(ctx);
+    }
+}
+
+void Widget::clearLayoutDirty() {
+    mLayoutDirty = mSubtreeLayoutDirty = false;
+    for (auto child : mChildren) {
+        if (child->mSubtreeLayoutDirty)
+            child->clearLayoutDirty();
+    }
+}
+
 void Widget::performLayout(NVGcontext *ctx) {
     if (mLayout) {
         mLayout->performLayout(ctx, this);
     } else {
         for (auto c : mChildren) {
-            Vector2i pref = c->preferredSize(ctx), fix = c->fixedSize();
+            Vector2i pref = c->cachedPreferredSize(ctx), fix = c->fixedSize();
             c->setSize(Vector2i(
                 fix[0] ? fix[0] : pref[0],
                 fix[1] ? fix[1] : pref[1]
             ));
-            c->performLayout(ctx);
+            Profiler::performLayout(c, ctx);
+        }
+    }
+}
+
+const HitGrid *Widget::hitGrid() {
+    if (mChildren.size() < HitGridMinChildren)
+        return nullptr;
+    if (mHitGrid && !mHitGridDirty)
+        return mHitGrid.get();
+    if (!mHitGrid)
+        mHitGrid.reset(new HitGrid());
+    mHitGridDirty = false;
+
+    HitGrid &grid = *mHitGrid;
+    Vector2i lo = Vector2i::Constant(std::numeric_limits<int>::max()),
+             hi = Vector2i::Constant(std::numeric_limits<int>::min());
+    int count = 0;
+    for (auto child : mChildren) {
+        if (!child->visible() || (child->size().array() <= 0).any())
+            continue;
+        lo = lo.cwiseMin(child->position());
+        hi = hi.cwiseMax(child->position() + child->size());
+        count++;
+    }
+
+    if (count == 0) {
+        grid.origin = grid.cellSize = Vector2i::Ones();
+        grid.cells = Vector2i::Zero();
+        grid.offsets.assign(1, 0);
+        grid.indices.clear();
+        return mHitGrid.get();
+    }
+
+    /* Aim for roughly one child per cell, with cells shaped like the bounds */
+    Vector2i extent = hi - lo;
+    int cx = (int) std::ceil(std::sqrt(count * extent.x() / (float) extent.y()));
+    cx = std::min(std::max(cx, 1), 256);
+    int cy = std::min(std::max((count + cx - 1) / cx, 1), 256);
+    grid.origin = lo;
+    grid.cells = Vector2i(cx, cy);
+    grid.cellSize = ((extent + grid.cells - Vector2i::Ones()).cwiseQuotient(grid.cells))
+        .cwiseMax(Vector2i::Ones());
+
+    /* Count the children per cell, then fill in their indices */
+    grid.offsets.assign(cx * cy + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<uint32_t> cursor;
+        if (pass == 1) {
+            for (int i = 0; i < cx * cy; ++i)
+                grid.offsets[i + 1] += grid.offsets[i];
+            grid.indices.resize(grid.offsets.back());
+            cursor.assign(grid.offsets.begin(), grid.offsets.end() - 1);
+        }
+        for (uint32_t i = 0; i < (uint32_t) mChildren.size(); ++i) {
+            const Widget *child = mChildren[i];
+            if (!child->visible() || (child->size().array() <= 0).any())
+                continue;
+            Vector2i c0 = (child->position() - lo).cwiseQuotient(grid.cellSize),
+                     c1 = (child->position() + child->size() - Vector2i::Ones() - lo)
+                              .cwiseQuotient(grid.cellSize);
+            for (int y = c0.y(); y <= c1.y(); ++y) {
+                for (int x = c0.x(); x <= c1.x(); ++x) {
+                    int cell = y * cx + x;
+                    if (pass == 0)
+                        grid.offsets[cell + 1]++;
+                    else
+                        grid.indices[cursor[cell]++] = i;
+                }
+            }
         }
     }
+    return mHitGrid.get();
+}
+
+void Widget::childrenAt(const Vector2i &p0, const Vector2i &p1, std::vector<Widget *> &result) {
+    result.clear();
+    const HitGrid *grid = hitGrid();
+    if (!grid) {
+        for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it)
+            if ((*it)->visible())
+                result.push_back(*it);
+        return;
+    }
+
+    /* Merge the (ascending) cell lists of both points, topmost child first */
+    auto r0 = grid->lookup(p0), r1 = grid->lookup(p1);
+    if (r0 == r1)
+        r1 = { nullptr, nullptr };
+    while (r0.second != r0.first || r1.second != r1.first) {
+        uint32_t index;
+        if (r1.second == r1.first ||
+            (r0.second != r0.first && r0.second[-1] >= r1.second[-1])) {
+            index = *--r0.second;
+            if (r1.second != r1.first && r1.second[-1] == index)
+                --r1.second;
+        } else {
+            index = *--r1.second;
+        }
+        result.push_back(mChildren[index]);
+    }
 }
 
 Widget *Widget::findWidget(const Vector2i &p) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
-        if (child->visible() && child->contains(p - mPos))
-            return child->findWidget(p - mPos);
+    const HitGrid *grid = hitGrid();
+    if (grid) {
+        auto range = grid->lookup(p - mPos);
+        for (auto it = range.second; it != range.first; ) {
+            Widget *child = mChildren[*--it];
+            if (child->visible() && child->contains(p - mPos))
+                return child->findWidget(p - mPos);
+        }
+    } else {
+        for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
+            Widget *child = *it;
+            if (child->visible() && child->contains(p - mPos))
+                return child->findWidget(p - mPos);
+        }
     }
     return contains(p) ? this : nullptr;
 }
 
 bool Widget::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
+    std::vector<Widget *> children;
+    childrenAt(p - mPos, p - mPos, children);
+    for (auto child : children) {
         if (child->visible() && child->contains(p - mPos) &&
             child->mouseButtonEvent(p - mPos, button, down, modifiers))
             return true;
@@ -92,8 +356,9 @@ bool Widget::mouseButtonEvent(const Vector2i &p, int button, bool down, int modi
 }
 
 bool Widget::mouseMotionEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
+    std::vector<Widget *> children;
+    childrenAt(p - mPos, p - mPos - rel, children);
+    for (auto child : children) {
         if (!child->visible())
             continue;
         bool contained = child->contains(p - mPos), prevContained = child->contains(p - mPos - rel);
@@ -107,8 +372,9 @@ bool Widget::mouseMotionEvent(const Vector2i &p, const Vector2i &rel, int button
 }
 
 bool Widget::scrollEvent(const Vector2i &p, const Vector2f &rel) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
+    std::vector<Widget *> children;
+    childrenAt(p - mPos, p - mPos, children);
+    for (auto child : children) {
         if (!child->visible())
             continue;
         if (child->contains(p - mPos) && child->scrollEvent(p - mPos, rel))
@@ -122,7 +388,11 @@ bool Widget::mouseDragEvent(const Vector2i &, const Vector2i &, int, int) {
 }
 
 bool Widget::mouseEnterEvent(const Vector2i &, bool enter) {
-    mMouseFocus = enter;
+    /* Many widgets are highlighted while the cursor hovers over them */
+    if (mMouseFocus != enter) {
+        mMouseFocus = enter;
+        invalidate();
+    }
     return false;
 }
 
@@ -139,54 +409,244 @@ bool Widget::keyboardCharacterEvent(unsigned int) {
     return false;
 }
 
+void *Widget::operator new(size_t size, WidgetPool *pool) {
+    if (!pool)
+        return ::operator new(size);
+    PoolHeader *header = (PoolHeader *) pool->allocate(size + PoolHeaderSize);
+    header->pool = pool;
+    header->size = size + PoolHeaderSize;
+    char *ptr = (char *) header + PoolHeaderSize;
+    pooledBlock = (uintptr_t) ptr;
+    pooledBlockEnd = (uintptr_t) (ptr + size);
+    return ptr;
+}
+
+void Widget::operator delete(void *ptr, size_t size) {
+    /* ~Widget() has just run for a pooled widget located in this block? */
+    uintptr_t begin = (uintptr_t) ptr;
+    if (releasedWidget >= begin && releasedWidget < begin + size) {
+        releasedWidget = 0;
+        releasePooledBlock(ptr);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
+void Widget::operator delete(void *ptr, WidgetPool *pool) {
+    if (pool) {
+        pooledBlock = pooledBlockEnd = releasedWidget = 0;
+        releasePooledBlock(ptr);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
+WidgetPool *Widget::widgetPool() {
+    Window *window = hasType(TypeWindow) ? static_cast<Window *>(this) : mWindow;
+    return window ? window->mWidgetPool.get() : nullptr;
+}
+
 void Widget::addChild(int index, Widget * widget) {
     assert(index <= childCount());
     mChildren.insert(mChildren.begin() + index, widget);
+    widget->mIndexInParent = (uint32_t) index;
+    mHitGridDirty = true;
     widget->incRef();
     widget->setParent(this);
+    if (Screen *screen = this->screen())
+        screen->registerIds(widget);
     widget->setTheme(mTheme);
+    widget->invalidate();
+    invalidatePreferredSize();
 }
 
 void Widget::addChild(Widget * widget) {
     addChild(childCount(), widget);
 }
 
+void Widget::addChildren(int index, const std::vector<Widget *> &widgets) {
+    assert(index <= childCount());
+    if (widgets.empty())
+        return;
+    mChildren.insert(mChildren.begin() + index, widgets.begin(), widgets.end());
+    mHitGridDirty = true;
+    Screen *screen = this->screen();
+    for (size_t i = 0; i < widgets.size(); ++i) {
+        Widget *widget = widgets[i];
+        widget->mIndexInParent = (uint32_t) (index + i);
+        widget->incRef();
+        widget->setParent(this);
+        if (screen)
+            screen->registerIds(widget);
+        widget->setTheme(mTheme);
+        widget->invalidate();
+    }
+    invalidatePreferredSize();
+}
+
 void Widget::removeChild(const Widget *widget) {
-    mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), widget), mChildren.end());
-    widget->decRef();
+    int index = childIndex(const_cast<Widget *>(widget));
+    if (index >= 0)
+        removeChild(index);
+}
+
+void Widget::clearChildren() {
+    if (mChildren.empty())
+        return;
+    Screen *screen = this->screen();
+    std::vector<Widget *> children(mChildren.begin(), mChildren.end());
+    for (auto child : children) {
+        child->invalidate();
+        if (screen)
+            screen->unregisterIds(child);
+    }
+    mChildren.clear();
+    mHitGridDirty = true;
+    invalidatePreferredSize();
+    for (auto child : children) {
+        child->setParent(nullptr);
+        child->decRef();
+    }
 }
 
 void Widget::removeChild(int index) {
     Widget *widget = mChildren[index];
+    widget->invalidate();
+    if (Screen *screen = this->screen())
+        screen->unregisterIds(widget);
     mChildren.erase(mChildren.begin() + index);
+    mHitGridDirty = true;
+    invalidatePreferredSize();
+    /* The widget may outlive its removal if it is referenced elsewhere */
+    widget->setParent(nullptr);
     widget->decRef();
 }
 
+static const std::string emptyString;
+
+Widget::Annotations &Widget::annotations() {
+    if (!mAnnotations)
+        mAnnotations.reset(new Annotations());
+    return *mAnnotations;
+}
+
+const std::string &Widget::id() const {
+    return mAnnotations ? mAnnotations->id : emptyString;
+}
+
+void Widget::setId(const std::string &id) {
+    if (id == this->id())
+        return;
+    Screen *screen = this->screen();
+    if (screen)
+        screen->unregisterId(this);
+    annotations().id = id;
+    if (screen)
+        screen->registerId(this);
+}
+
+const std::string &Widget::tooltip() const {
+    return mAnnotations ? mAnnotations->tooltip : emptyString;
+}
+
+void Widget::setTooltip(const std::string &tooltip) {
+    if (tooltip == this->tooltip())
+        return;
+    annotations().tooltip = tooltip;
+    invalidate();
+}
+
 int Widget::childIndex(Widget *widget) const {
-    auto it = std::find(mChildren.begin(), mChildren.end(), widget);
-    if (it == mChildren.end())
-        return -1;
-    return it - mChildren.begin();
+    uint32_t index = widget->mIndexInParent;
+    if (index < mChildren.size() && mChildren[index] == widget)
+        return (int) index;
+
+    /* Children were inserted or removed before the widget: renumber them all */
+    int result = -1;
+    for (size_t i = 0; i < mChildren.size(); ++i) {
+        mChildren[i]->mIndexInParent = (uint32_t) i;
+        if (mChildren[i] == widget)
+            result = (int) i;
+    }
+    return result;
 }
 
-Window *Widget::window() {
-    Widget *widget = this;
-    while (true) {
-        if (!widget)
-            throw std::runtime_error(
-                "Widget:internal error (could not find parent window)");
-        Window *window = dynamic_cast<Window *>(widget);
-        if (window)
-            return window;
-        widget = widget->parent();
+void Widget::setParent(Widget *parent) {
+    mParent = parent;
+    updateAncestors();
+    invalidateAbsolutePosition();
+}
+
+const Vector2i &Widget::absolutePosition() const {
+    if (!mAbsolutePosValid) {
+        mAbsolutePos = mParent ? mParent->absolutePosition() + mPos : mPos;
+        mAbsolutePosValid = true;
     }
+    return mAbsolutePos;
+}
+
+void Widget::invalidateAbsolutePosition() {
+    /* A valid cache implies valid caches of all ancestors, hence the
+       descendants of a widget without a valid cache need not be visited */
+    if (!mAbsolutePosValid)
+        return;
+    mAbsolutePosValid = false;
+    for (auto child : mChildren)
+        child->invalidateAbsolutePosition();
+}
+
+void Widget::updateAncestors() {
+    if (mParent) {
+        mWindow = mParent->hasType(TypeWindow) ? static_cast<Window *>(mParent) : mParent->mWindow;
+        mScreen = mParent->hasType(TypeScreen) ? static_cast<Screen *>(mParent) : mParent->mScreen;
+    } else {
+        mWindow = nullptr;
+        mScreen = nullptr;
+    }
+    for (auto child : mChildren)
+        child->updateAncestors();
+}
+
+Window *Widget::window() {
+    if (hasType(TypeWindow))
+        return static_cast<Window *>(this);
+    if (!mWindow)
+        throw std::runtime_error(
+            "Widget:internal error (could not find parent window)");
+    return mWindow;
+}
+
+Screen *Widget::screen() {
+    return hasType(TypeScreen) ? static_cast<Screen *>(this) : mScreen;
 }
 
 void Widget::requestFocus() {
+    if (Screen *screen = this->screen())
+        screen->updateFocus(this);
+}
+
+void Widget::invalidate(bool force) {
     Widget *widget = this;
-    while (widget->parent())
+    Vector2i pos = mPos;
+    bool visible = mVisible;
+    while (widget->parent()) {
         widget = widget->parent();
-    ((Screen *) widget)->updateFocus(this);
+        widget->descendantInvalidated();
+        pos += widget->mPos;
+        visible &= widget->mVisible;
+    }
+    if (!visible && !force)
+        return;
+    /* Widgets that are not (yet) attached to a screen have nothing to redraw */
+    Screen *screen = widget_cast<Screen>(widget);
+    if (screen)
+        screen->invalidateRect(pos, mSize);
+}
+
+void Widget::scheduleRedraw(double delay) {
+    Screen *screen = this->screen();
+    if (screen)
+        screen->scheduleRedraw(this, screen->time() + delay);
 }
 
 void Widget::draw(NVGcontext *ctx) {
@@ -202,9 +662,18 @@ void Widget::draw(NVGcontext *ctx) {
         return;
 
     nvgTranslate(ctx, mPos.x(), mPos.y());
-    for (auto child : mChildren)
-        if (child->visible())
-            child->draw(ctx);
+    Vector2f clipMin, clipMax;
+    ClipScope::bounds(ctx, clipMin, clipMax);
+    for (auto child : mChildren) {
+        if (!child->visible())
+            continue;
+        /* Skip children (along with their descendants) that cannot be seen */
+        Vector2f p0 = (child->position() - Vector2i::Constant(ClipMargin)).cast<float>(),
+                 p1 = (child->position() + child->size() + Vector2i::Constant(ClipMargin)).cast<float>();
+        if ((p1.array() <= clipMin.array()).any() || (p0.array() >= clipMax.array()).any())
+            continue;
+        Profiler::draw(child, ctx);
+    }
     nvgTranslate(ctx, -mPos.x(), -mPos.y());
 }
 
@@ -212,24 +681,43 @@ void Widget::save(Serializer &s) const {
     s.set("position", mPos);
     s.set("size", mSize);
     s.set("fixedSize", mFixedSize);
-    s.set("visible", mVisible);
-    s.set("enabled", mEnabled);
-    s.set("focused", mFocused);
-    s.set("tooltip", mTooltip);
+    s.set("visible", (bool) mVisible);
+    s.set("enabled", (bool) mEnabled);
+    s.set("focused", (bool) mFocused);
+    s.set("tooltip", tooltip());
     s.set("fontSize", mFontSize);
     s.set("cursor", (int) mCursor);
 }
 
 bool Widget::load(Serializer &s) {
+    /* Damage the area covered before loading */
+    invalidate();
     if (!s.get("position", mPos)) return false;
+    invalidateAbsolutePosition();
     if (!s.get("size", mSize)) return false;
     if (!s.get("fixedSize", mFixedSize)) return false;
-    if (!s.get("visible", mVisible)) return false;
-    if (!s.get("enabled", mEnabled)) return false;
-    if (!s.get("focused", mFocused)) return false;
-    if (!s.get("tooltip", mTooltip)) return false;
+    bool visible, enabled, focused;
+    std::string tooltip;
+    if (!s.get("visible", visible)) return false;
+    if (!s.get("enabled", enabled)) return false;
+    if (!s.get("focused", focused)) return false;
+    if (!s.get("tooltip", tooltip)) return false;
+    mVisible = visible;
+    mEnabled = enabled;
+    mFocused = focused;
+    if (!tooltip.empty() || mAnnotations)
+        annotations().tooltip = tooltip;
     if (!s.get("fontSize", mFontSize)) return false;
     if (!s.get("cursor", mCursor)) return false;
+    /* The state was assigned without the setters, so everything depending on
+       it is invalidated here. This also covers the state that subclasses
+       load afterwards, since nothing is measured or drawn in between */
+    invalidate();
+    invalidatePreferredSize();
+    if (mParent) {
+        mParent->invalidateLayout();
+        mParent->mHitGridDirty = true;
+    }
     return true;
 }
 
@@ -0,0 +1,123 @@
+/*
+    src/widgetmemory.cpp -- Benchmark that reports the memory footprint
+    of a synthetic tree of one million widgets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/widget.h>
+#include <nanogui/label.h>
+#include <nanogui/button.h>
+#include <nanogui/widgetpool.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/* Account for all heap allocations by prefixing each block with its size */
+static std::atomic<size_t> heapBytes(0), heapBlocks(0);
+static const size_t HeaderSize = 16;
+
+void *operator new(size_t size) {
+    char *ptr = (char *) std::malloc(size + HeaderSize);
+    if (!ptr)
+        throw std::bad_alloc();
+    *(size_t *) ptr = size;
+    heapBytes += size;
+    heapBlocks++;
+    return ptr + HeaderSize;
+}
+
+void operator delete(void *ptr) noexcept {
+    if (!ptr)
+        return;
+    char *block = (char *) ptr - HeaderSize;
+    heapBytes -= *(size_t *) block;
+    heapBlocks--;
+    std::free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+using namespace nanogui;
+
+/* Window-like panels, each with a few hundred rows of a label and two buttons
+   as they occur in property editors. Only every tenth button has a tooltip and
+   every hundredth row an ID, which is typical for real applications. */
+static const int Panels = 1000, RowsPerPanel = 250;
+
+static size_t buildTree(Widget *root, WidgetPool *pool) {
+    size_t count = 0;
+    for (int i = 0; i < Panels; ++i) {
+        Widget *panel = new (pool) Widget(root);
+        count++;
+        for (int j = 0; j < RowsPerPanel; ++j) {
+            Widget *row = new (pool) Widget(panel);
+            if (j % 100 == 0)
+                row->setId("row" + std::to_string(i) + "." + std::to_string(j));
+            new (pool) Label(row, "Property");
+            Button *button = new (pool) Button(row, "Edit");
+            if (j % 10 == 0)
+                button->setTooltip("Edit the property");
+            new (pool) Button(row, "Reset");
+            count += 4;
+        }
+    }
+    return count;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* Build the tree, then tear it down and build it again, which reuses the
+   blocks of the pool (if any) */
+static void run(const char *name, WidgetPool *pool) {
+    size_t bytesBefore = heapBytes, blocksBefore = heapBlocks;
+    ref<Widget> root = new Widget(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t count = buildTree(root, pool) + 1;
+    double buildTime = seconds(start);
+    size_t bytes = heapBytes - bytesBefore, blocks = heapBlocks - blocksBefore;
+
+    start = std::chrono::steady_clock::now();
+    root->clearChildren();
+    double clearTime = seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    buildTree(root, pool);
+    double rebuildTime = seconds(start);
+
+    printf("\n%s: %zu widgets\n", name, count);
+    printf("  build %.3f s, clear %.3f s, rebuild %.3f s\n", buildTime, clearTime, rebuildTime);
+    printf("  heap: %.1f MiB in %zu allocations\n", bytes / (1024.0 * 1024.0), blocks);
+    printf("  per widget: %.1f bytes, %.2f allocations\n",
+           bytes / (double) count, blocks / (double) count);
+}
+
+int main(int /* argc */, char ** /* argv */) {
+    printf("sizeof(Widget)     = %zu bytes\n", sizeof(Widget));
+    printf("sizeof(WidgetList) = %zu bytes\n", sizeof(WidgetList));
+    printf("sizeof(Label)      = %zu bytes\n", sizeof(Label));
+    printf("sizeof(Button)     = %zu bytes\n", sizeof(Button));
+
+    size_t bytesBefore = heapBytes;
+    run("heap", nullptr);
+    {
+        /* The pool is released along with the last widget allocated from it */
+        ref<WidgetPool> pool = new WidgetPool();
+        run("pool", pool);
+    }
+    if (heapBytes != bytesBefore)
+        printf("\nwarning: %zu bytes were not released\n", (size_t) (heapBytes - bytesBefore));
+    return 0;
+}
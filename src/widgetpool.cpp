@@ -0,0 +1,68 @@
+/*
+    src/widgetpool.cpp -- Pool allocator for the widgets of a window
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/widgetpool.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(nanogui)
+
+WidgetPool::WidgetPool(size_t chunkSize)
+    : mChunkSize(std::max(chunkSize, (size_t) MaxBlockSize)), mCursor(nullptr),
+      mEnd(nullptr), mBlockCount(0) {
+    std::fill(std::begin(mFree), std::end(mFree), nullptr);
+}
+
+WidgetPool::~WidgetPool() {
+    for (char *chunk : mChunks)
+        delete[] chunk;
+}
+
+void *WidgetPool::allocate(size_t size) {
+    size_t sizeClass = (size - 1) / Granularity;
+    void *ptr = nullptr;
+    if (size == 0 || size > MaxBlockSize) {
+        ptr = ::operator new(size);
+    } else if (mFree[sizeClass]) {
+        ptr = mFree[sizeClass];
+        mFree[sizeClass] = mFree[sizeClass]->next;
+    } else {
+        size_t blockSize = (sizeClass + 1) * Granularity;
+        if ((size_t) (mEnd - mCursor) < blockSize) {
+            /* The remainder of the previous chunk (less than a block) is not used */
+            char *chunk = new char[mChunkSize];
+            mChunks.push_back(chunk);
+            mCursor = chunk;
+            mEnd = chunk + mChunkSize;
+        }
+        ptr = mCursor;
+        mCursor += blockSize;
+    }
+
+    /* Every block keeps the pool alive */
+    mBlockCount++;
+    incRef();
+    return ptr;
+}
+
+void WidgetPool::deallocate(void *ptr, size_t size) {
+    if (size == 0 || size > MaxBlockSize) {
+        ::operator delete(ptr);
+    } else {
+        size_t sizeClass = (size - 1) / Granularity;
+        FreeBlock *block = (FreeBlock *) ptr;
+        block->next = mFree[sizeClass];
+        mFree[sizeClass] = block;
+    }
+    mBlockCount--;
+    decRef();
+}
+
+NAMESPACE_END(nanogui)
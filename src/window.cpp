@@ -12,53 +12,54 @@
 #include <nanogui/window.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textlayout.h>
 #include <nanogui/screen.h>
+#include <nanogui/popup.h>
 #include <nanogui/layout.h>
 #include <nanogui/serializer/core.h>
 
 NAMESPACE_BEGIN(nanogui)
 
 Window::Window(Widget *parent, const std::string &title)
-    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false) { }
+    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false) {
+    mTypeTags |= TypeWindow;
+}
+
+Window::~Window() {
+    for (auto popup : mPopups)
+        popup->mParentWindow = nullptr;
+}
 
 Vector2i Window::preferredSize(NVGcontext *ctx) const {
-    if (mButtonPanel)
-        mButtonPanel->setVisible(false);
+    /* The button panel is excluded from the layout (see buttonPanel()) */
     Vector2i result = Widget::preferredSize(ctx);
-    if (mButtonPanel)
-        mButtonPanel->setVisible(true);
-
-    nvgFontSize(ctx, 18.0f);
-    nvgFontFace(ctx, "sans-bold");
-    float bounds[4];
-    nvgTextBounds(ctx, 0, 0, mTitle.c_str(), nullptr, bounds);
 
+    auto title = TextLayoutCache::instance().layout("sans-bold", 18.0f, mTitle);
     return result.cwiseMax(Vector2i(
-        bounds[2]-bounds[0] + 20, bounds[3]-bounds[1]
+        (int) title->size.x() + 20,
+        (int) title->lineHeight
     ));
 }
 
 Widget *Window::buttonPanel() {
     if (!mButtonPanel) {
         mButtonPanel = new Widget(this);
+        /* Placed in the header by performLayout() */
+        mButtonPanel->setExcludedFromLayout(true);
         mButtonPanel->setLayout(new BoxLayout(Orientation::Horizontal, Alignment::Middle, 0, 4));
     }
     return mButtonPanel;
 }
 
 void Window::performLayout(NVGcontext *ctx) {
-    if (!mButtonPanel) {
-        Widget::performLayout(ctx);
-    } else {
-        mButtonPanel->setVisible(false);
-        Widget::performLayout(ctx);
+    Widget::performLayout(ctx);
+    if (mButtonPanel) {
         for (auto w : mButtonPanel->children()) {
             w->setFixedSize(Vector2i(22, 22));
             w->setFontSize(15);
         }
-        mButtonPanel->setVisible(true);
         mButtonPanel->setSize(Vector2i(width(), 22));
-        mButtonPanel->setPosition(Vector2i(width() - (mButtonPanel->preferredSize(ctx).x() + 5), 3));
+        mButtonPanel->setPosition(Vector2i(width() - (mButtonPanel->cachedPreferredSize(ctx).x() + 5), 3));
         mButtonPanel->performLayout(ctx);
     }
 }
@@ -139,25 +140,21 @@ void Window::draw(NVGcontext *ctx) {
 }
 
 void Window::dispose() {
-    Widget *widget = this;
-    while (widget->parent())
-        widget = widget->parent();
-    ((Screen *) widget)->disposeWindow(this);
+    screen()->disposeWindow(this);
 }
 
 void Window::center() {
-    Widget *widget = this;
-    while (widget->parent())
-        widget = widget->parent();
-    ((Screen *) widget)->centerWindow(this);
+    screen()->centerWindow(this);
 }
 
 bool Window::mouseDragEvent(const Vector2i &, const Vector2i &rel,
                             int button, int /* modifiers */) {
     if (mDrag && (button & (1 << GLFW_MOUSE_BUTTON_1)) != 0) {
-        mPos += rel;
-        mPos = mPos.cwiseMax(Vector2i::Zero());
-        mPos = mPos.cwiseMin(parent()->size() - mSize);
+        Vector2i pos = mPos + rel;
+        pos = pos.cwiseMax(Vector2i::Zero());
+        pos = pos.cwiseMin(parent()->size() - mSize);
+        setPosition(pos);
+        refreshRelativePlacement();
         return true;
     }
     return false;
@@ -179,7 +176,8 @@ bool Window::scrollEvent(const Vector2i &p, const Vector2f &rel) {
 }
 
 void Window::refreshRelativePlacement() {
-    /* Overridden in \ref Popup */
+    for (auto popup : mPopups)
+        popup->refreshRelativePlacement();
 }
 
 void Window::save(Serializer &s) const {
@@ -0,0 +1,73 @@
+/*
+    tests/layout.cpp -- Measures and lays out a small widget tree without
+    a screen or NanoVG context
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/widget.h>
+#include <nanogui/layout.h>
+#include <cstdio>
+
+using namespace nanogui;
+
+static int failures = 0;
+
+static void check(bool condition, const char *what) {
+    if (!condition) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+int main(int /* argc */, char ** /* argv */) {
+    ref<Widget> root = new Widget(nullptr);
+    root->setLayout(new BoxLayout(Orientation::Vertical, Alignment::Fill, 5, 10));
+
+    Widget *a = new Widget(root);
+    a->setFixedSize(Vector2i(40, 20));
+    Widget *b = new Widget(root);
+    b->setFixedSize(Vector2i(60, 30));
+
+    /* A leaf without a layout prefers its current size */
+    Widget *leaf = new Widget(nullptr);
+    leaf->incRef();
+    leaf->setSize(Vector2i(10, 20));
+    check(leaf->cachedPreferredSize(nullptr) == Vector2i(10, 20), "leaf preferred size");
+    leaf->decRef();
+
+    Vector2i expected(5 + 60 + 5, 5 + 20 + 10 + 30 + 5);
+    check(root->cachedPreferredSize(nullptr) == expected, "box layout preferred size");
+    /* The second query is answered from the cache */
+    check(root->cachedPreferredSize(nullptr) == expected, "cached preferred size");
+
+    root->setSize(expected);
+    root->performLayout(nullptr);
+    check(a->position() == Vector2i(5, 5), "position of the first child");
+    check(b->position() == Vector2i(5, 35), "position of the second child");
+    check(a->size() == Vector2i(40, 20), "size of the first child");
+
+    /* Changing a child invalidates the cached size of its ancestors */
+    b->setFixedSize(Vector2i(80, 30));
+    check(root->cachedPreferredSize(nullptr) == Vector2i(90, expected.y()),
+          "preferred size after a change");
+
+    /* Excluded children are neither measured nor placed by the layout */
+    Widget *excluded = new Widget(root);
+    excluded->setFixedSize(Vector2i(200, 200));
+    excluded->setPosition(Vector2i(1, 2));
+    excluded->setExcludedFromLayout(true);
+    check(root->cachedPreferredSize(nullptr) == Vector2i(90, expected.y()),
+          "preferred size with an excluded child");
+    root->performLayout(nullptr);
+    check(excluded->position() == Vector2i(1, 2), "position of an excluded child");
+
+    if (failures == 0)
+        printf("layout: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}